@@ -23,6 +23,7 @@
  **************************************************************************/
 
 #include <XMC1300.h>
+#include "asc_transport.h"
 
 /* USIC : FIFO DPTR & SIZE MASK and POS Values */ 
 #define   USIC_CH_TBCTR_DPTRSIZE_Pos  	(0U)
@@ -31,28 +32,28 @@
 #define   USIC_CH_RBCTR_DPTRSIZE_Pos  	(0U)
 #define   USIC_CH_RBCTR_DPTRSIZE_Msk  	(0x0700003FU << USIC_CH_RBCTR_DPTRSIZE_Pos)
 
+#if ASC_CHANNEL == ASC_CHANNEL_AUTO
+USIC_CH_TypeDef* AscChannel = USIC0_CH0;
+#endif
+
 void ASC_Init(void)
 {              	         
 
-//********* MODULE USIC CONFIGURATIONS for using P1.3 as RXD *************************
-   /*USIC 0 Channel 0 Mux Related SFR/Bitfields Configurations*/ 									  					 				 				 		       				              				  					    					 					   				  					 				 				       				  										 									 					 					  									      					              					  						    					      
- WR_REG(USIC0_CH1->DX0CR, USIC_CH_DX0CR_DSEL_Msk, USIC_CH_DX0CR_DSEL_Pos,0);
+#if ASC_CHANNEL == ASC_CHANNEL_AUTO
+ // the ROM BSL leaves only the channel it was started on in ASC mode
+ if (((USIC0_CH0->CCR & USIC_CH_CCR_MODE_Msk) >> USIC_CH_CCR_MODE_Pos) != 2)
+	AscChannel = USIC0_CH1;
+#endif
+
+//********* MODULE USIC CONFIGURATIONS for the ASC_CHANNEL RXD pin *******************
+   /*USIC 0 Channel Mux Related SFR/Bitfields Configurations*/
+ WR_REG(ASC_CH->DX0CR, USIC_CH_DX0CR_DSEL_Msk, USIC_CH_DX0CR_DSEL_Pos,ASC_DX0_DSEL);
 	
    // Data Pointer & Buffer Size for Transmitter Buffer Control  
- WR_REG(USIC0_CH1->TBCTR, USIC_CH_TBCTR_DPTRSIZE_Msk, USIC_CH_TBCTR_DPTRSIZE_Pos,0x01000000);		/*    DPTR = 0,  SIZE = 1 */
+ WR_REG(ASC_CH->TBCTR, USIC_CH_TBCTR_DPTRSIZE_Msk, USIC_CH_TBCTR_DPTRSIZE_Pos,ASC_TBCTR_DPTRSIZE);
            
-  // Data Pointer & Buffer Size for Receiver Buffer Control  
- WR_REG(USIC0_CH1->RBCTR, USIC_CH_RBCTR_DPTRSIZE_Msk, USIC_CH_RBCTR_DPTRSIZE_Pos,0x01000000);		/*    DPTR = 0,  SIZE = 1 */
-
- //********* MODULE USIC CONFIGURATIONS for using P0.14 as RXD *************************
-    /*USIC 0 Channel 0 Mux Related SFR/Bitfields Configurations*/
-//  WR_REG(USIC0_CH0->DX0CR, USIC_CH_DX0CR_DSEL_Msk, USIC_CH_DX0CR_DSEL_Pos,0);
-
-    // Data Pointer & Buffer Size for Transmitter Buffer Control
-//  WR_REG(USIC0_CH0->TBCTR, USIC_CH_TBCTR_DPTRSIZE_Msk, USIC_CH_TBCTR_DPTRSIZE_Pos,0x01000000);		/*    DPTR = 0,  SIZE = 1 */
-
-   // Data Pointer & Buffer Size for Receiver Buffer Control
-//  WR_REG(USIC0_CH0->RBCTR, USIC_CH_RBCTR_DPTRSIZE_Msk, USIC_CH_RBCTR_DPTRSIZE_Pos,0x01000000);		/*    DPTR = 0,  SIZE = 1 */
+  // Data Pointer & Buffer Size for Receiver Buffer Control, the FIFO is off while DPTR changes
+ WR_REG(ASC_CH->RBCTR, USIC_CH_RBCTR_DPTRSIZE_Msk, USIC_CH_RBCTR_DPTRSIZE_Pos,0);
+ WR_REG(ASC_CH->RBCTR, USIC_CH_RBCTR_DPTRSIZE_Msk, USIC_CH_RBCTR_DPTRSIZE_Pos,ASC_RBCTR_DPTRSIZE);
 				       
 }
-
@@ -584,6 +584,31 @@ typedef struct XMC_CCU4_SLICE_CAPTURE_CONFIG
 #elif defined(__TASKING__)
   #pragma warning restore
 #endif
+
+/**
+ *  Capture register set drained into a timestamp buffer by XMC_CCU4_DrainCaptures()
+ */
+typedef struct XMC_CCU4_CAPTURE_BUFFER
+{
+  XMC_CCU4_SLICE_t *slice;               /**< Slice owning the capture registers */
+  XMC_CCU4_SLICE_CAP_REG_SET_t set;      /**< Capture register set to drain */
+  uint32_t *values;                      /**< Captured values, oldest first: timer value in bits 0..15, floating
+                                              prescaler value in bits 16..19 */
+  uint32_t size;                         /**< Number of values the buffer holds */
+  uint32_t count;                        /**< Number of values stored, reset by the application or lowered by
+                                              XMC_CCU4_GetPwmMeasurements() */
+  uint32_t lost;                         /**< Captures dropped because the buffer was full or overwritten before
+                                              they were read (extended capture read mode only) */
+} XMC_CCU4_CAPTURE_BUFFER_t;
+
+/**
+ *  Period and pulse width of a PWM input, derived by XMC_CCU4_GetPwmMeasurements()
+ */
+typedef struct XMC_CCU4_PWM_MEASUREMENT
+{
+  uint16_t period;                       /**< Timer ticks between two period start edges */
+  uint16_t pulse;                        /**< Timer ticks from the period start edge to the pulse end edge */
+} XMC_CCU4_PWM_MEASUREMENT_t;
 /*********************************************************************************************************************
  * API Prototypes
  ********************************************************************************************************************/
@@ -1807,6 +1832,56 @@ XMC_CCU4_STATUS_t XMC_CCU4_SLICE_GetLastCapturedTimerValue(const XMC_CCU4_SLICE_
                                                            const XMC_CCU4_SLICE_CAP_REG_SET_t set,
                                                            uint32_t *val_ptr);
 
+/**
+ * @param buffers Array of capture register sets and their timestamp buffers
+ * @param num_buffers Number of elements in \b buffers
+ * @return <BR>
+ *    None<BR>
+ *
+ * \par<b>Description:</b><br>
+ * Moves all captured values of a group of slices into their timestamp buffers in one pass.\n\n
+ * Each full capture register of a set is read once, oldest first, which clears its full flag so that the slice
+ * can capture again. With extended capture read mode the set is read through CC4yECRD0/CC4yECRD1 until the full
+ * flag is clear and values overwritten in hardware are counted in \b lost. Values that find the buffer full are
+ * read and dropped as well, and counted in \b lost. Meant to be called once per capture interrupt (or from a
+ * periodic task) for all slices, instead of one interrupt per edge.
+ *
+ * \par<b>Related APIs:</b><br>
+ *  XMC_CCU4_GetPwmMeasurements()<BR> XMC_CCU4_SLICE_GetLastCapturedTimerValue().
+ */
+void XMC_CCU4_DrainCaptures(XMC_CCU4_CAPTURE_BUFFER_t *const buffers, const uint32_t num_buffers);
+
+/**
+ * @param period_buffer Values captured on the period start edge, with the timer cleared by the capture
+ * @param pulse_buffer Values captured on the pulse end edge
+ * @param results Array receiving period and pulse width of each period, oldest first
+ * @param max Size of \b results
+ * @return <BR>
+ *    uint32_t Number of measurements stored in \b results.
+ *
+ * \par<b>Description:</b><br>
+ * Derives period and pulse width of a PWM input from two drained capture sets.\n\n
+ * The slice is set up to capture into one set on the edge starting a period and to clear the timer with it, and
+ * into the other set on the edge ending the pulse. A period start capture holds the length of the period before
+ * it, so period i is made of pulse end value i and period start value i + 1 of the buffers. The values of the
+ * measured periods are removed from both buffers. The start of the period still open, and its pulse end if it
+ * was already drained, stay in the buffers, so the pairing holds across drains however they fall between the
+ * edges. The buffers must not be reset by the application between calls.
+ * The floating prescaler value is ignored.
+ *
+ * \par<b>Note:</b><br>
+ * The first capture into \b period_buffer must be a period start edge, i.e. the slice is started by that edge
+ * (external start), and its value is dropped. After captures were lost (\b lost not 0) the pairing is no longer
+ * known and both buffers have to be restarted together with the slice.
+ *
+ * \par<b>Related APIs:</b><br>
+ *  XMC_CCU4_DrainCaptures().
+ */
+uint32_t XMC_CCU4_GetPwmMeasurements(XMC_CCU4_CAPTURE_BUFFER_t *const period_buffer,
+                                     XMC_CCU4_CAPTURE_BUFFER_t *const pulse_buffer,
+                                     XMC_CCU4_PWM_MEASUREMENT_t *const results,
+                                     const uint32_t max);
+
 /**
  * @param slice Constant pointer to CC4 Slice
  * @param event Event whose assertion can potentially lead to an interrupt
@@ -372,6 +372,86 @@ __STATIC_INLINE uint32_t XMC_GPIO_GetInput(XMC_GPIO_PORT_t *const port, const ui
   return (((port->IN) >> pin) & 0x1U);
 }
 
+/**
+ *
+ * @param port constant pointer pointing to GPIO port, to access hardware register Pn_OMR.
+ * @param set_mask   pins to drive high, bit n selects pin n.
+ * @param clear_mask pins to drive low, bit n selects pin n.
+ *
+ * @return None
+ *
+ * \par<b>Description:</b><br>
+ * Sets and clears several port pin outputs with a single write of the Pn_OMR register, so all selected pins change
+ * in the same clock cycle and pins outside both masks keep their level. A pin in both masks is toggled.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_GPIO_SetOutputHigh(), XMC_GPIO_SetOutputLow(), XMC_GPIO_ModifyOutputGetInput().
+ *
+ * \par<b>Note:</b><br>
+ * Prior to this api, user has to configure the port pins to output mode using XMC_GPIO_SetMode(). With constant
+ * masks the call is a single Pn_OMR store, which makes it the building block of bit-banged clock edges.
+ *
+ */
+
+__STATIC_INLINE void XMC_GPIO_ModifyOutput(XMC_GPIO_PORT_t *const port, const uint16_t set_mask,
+                                           const uint16_t clear_mask)
+{
+  XMC_ASSERT("XMC_GPIO_ModifyOutput: Invalid port", XMC_GPIO_CHECK_OUTPUT_PORT(port));
+
+  port->OMR = (uint32_t)set_mask | ((uint32_t)clear_mask << 16U);
+}
+
+/**
+ *
+ * @param port constant pointer pointing to GPIO port, to access hardware registers Pn_OMR and Pn_IN.
+ * @param set_mask   pins to drive high, bit n selects pin n.
+ * @param clear_mask pins to drive low, bit n selects pin n.
+ *
+ * @return uint32_t logic levels of all pins of the port, read after the write.
+ *
+ * \par<b>Description:</b><br>
+ * Same as XMC_GPIO_ModifyOutput(), followed by a read of the Pn_IN register, e.g. to drive a clock edge and sample a
+ * data line in one inline sequence.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_GPIO_ModifyOutput(), XMC_GPIO_GetInputMask().
+ *
+ * \par<b>Note:</b><br>
+ * Pn_IN passes the input synchronizer, so the levels read back reflect the pins as they were a few cycles before
+ * the write, not the levels just driven. The read adds one Pn_IN load to the store of XMC_GPIO_ModifyOutput().
+ *
+ */
+
+__STATIC_INLINE uint32_t XMC_GPIO_ModifyOutputGetInput(XMC_GPIO_PORT_t *const port, const uint16_t set_mask,
+                                                       const uint16_t clear_mask)
+{
+  XMC_ASSERT("XMC_GPIO_ModifyOutputGetInput: Invalid port", XMC_GPIO_CHECK_OUTPUT_PORT(port));
+
+  port->OMR = (uint32_t)set_mask | ((uint32_t)clear_mask << 16U);
+  return port->IN;
+}
+
+/**
+ *
+ * @param port constant pointer pointing to GPIO port, to access hardware register Pn_IN.
+ *
+ * @return uint32_t logic levels of all pins of the port, bit n is pin n.
+ *
+ * \par<b>Description:</b><br>
+ * Reads the Pn_IN register once, so several pins are sampled at the same time.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_GPIO_GetInput()
+ *
+ */
+
+__STATIC_INLINE uint32_t XMC_GPIO_GetInputMask(XMC_GPIO_PORT_t *const port)
+{
+  XMC_ASSERT("XMC_GPIO_GetInputMask: Invalid port", XMC_GPIO_CHECK_PORT(port));
+
+  return port->IN;
+}
+
 /**
  * @param port constant pointer pointing to GPIO port, to access hardware register Pn_PPS.
  * @param pin  port pin number.
@@ -195,6 +195,17 @@ typedef enum XMC_I2C_CH_INPUT
 #endif  
 } XMC_I2C_CH_INPUT_t;
 
+/**
+ * @brief Result of a queued transaction, see XMC_I2C_CH_QueueSubmit()
+ */
+typedef enum XMC_I2C_CH_TRANSACTION_STATUS
+{
+  XMC_I2C_CH_TRANSACTION_STATUS_DONE,     /**< All messages transferred */
+  XMC_I2C_CH_TRANSACTION_STATUS_PENDING,  /**< Waiting in the queue or running */
+  XMC_I2C_CH_TRANSACTION_STATUS_NACK,     /**< Address or data byte not acknowledged, stopped */
+  XMC_I2C_CH_TRANSACTION_STATUS_ERROR     /**< Arbitration lost or protocol error */
+} XMC_I2C_CH_TRANSACTION_STATUS_t;
+
 /*******************************************************************************
  * DATA STRUCTURES
  *******************************************************************************/
@@ -207,6 +218,51 @@ typedef struct XMC_I2C_CH_CONFIG
   uint16_t address;    /**< master's own address  (used in multi-master mode) */
 } XMC_I2C_CH_CONFIG_t;
 
+/**
+ * @brief One message of a queued transaction: start (or repeated start), address and data bytes
+ */
+typedef struct XMC_I2C_CH_MSG
+{
+  uint16_t address;          /**< Slave address as for XMC_I2C_CH_MasterStart(), 7 bit address shifted left by one */
+  XMC_I2C_CH_CMD_t command;  /**< Write or read */
+  uint8_t *data;             /**< Bytes to send, or buffer for the received bytes */
+  uint32_t length;           /**< Number of data bytes, at least 1 for a read */
+} XMC_I2C_CH_MSG_t;
+
+struct XMC_I2C_CH_TRANSACTION;
+
+/**
+ * @brief Completion callback, called from XMC_I2C_CH_QueueHandler()
+ */
+typedef void (*XMC_I2C_CH_TRANSACTION_CALLBACK_t)(struct XMC_I2C_CH_TRANSACTION *const transaction);
+
+/**
+ * @brief Messages run back to back, joined by repeated starts and closed by a stop condition
+ */
+typedef struct XMC_I2C_CH_TRANSACTION
+{
+  XMC_I2C_CH_MSG_t *msgs;                            /**< Messages of the transaction */
+  uint32_t count;                                    /**< Number of messages */
+  XMC_I2C_CH_TRANSACTION_CALLBACK_t callback;        /**< Called on completion, may be NULL */
+  void *context;                                     /**< Free for the caller */
+  volatile XMC_I2C_CH_TRANSACTION_STATUS_t status;   /**< Set by the queue */
+  struct XMC_I2C_CH_TRANSACTION *next;               /**< Queue link, set by the queue */
+} XMC_I2C_CH_TRANSACTION_t;
+
+/**
+ * @brief Transaction queue of a master channel, driven by the channel interrupts
+ */
+typedef struct XMC_I2C_CH_QUEUE
+{
+  XMC_USIC_CH_t *channel;                     /**< USIC channel in I2C master mode */
+  XMC_I2C_CH_TRANSACTION_t *volatile head;    /**< Running transaction, NULL if idle */
+  XMC_I2C_CH_TRANSACTION_t *tail;             /**< Last queued transaction */
+  uint32_t msg;                               /**< Message of the running transaction */
+  uint32_t pos;                               /**< Data bytes of the message transferred */
+  XMC_I2C_CH_TRANSACTION_STATUS_t result;     /**< Status reported once the stop condition is seen */
+  volatile uint8_t state;                     /**< Bus phase, internal */
+} XMC_I2C_CH_QUEUE_t;
+
 /*******************************************************************************
  * API PROTOTYPES
  *******************************************************************************/
@@ -579,6 +635,73 @@ __STATIC_INLINE void XMC_I2C_CH_ClearStatusFlag(XMC_USIC_CH_t *const channel, ui
   channel->PSCR |= flag;
 }
 
+/**
+ * @param queue Queue to set up
+ * @param channel Constant pointer to USIC channel structure of type @ref XMC_USIC_CH_t, initialized with
+ *                XMC_I2C_CH_Init() and started, without transmit FIFO
+ * @param service_request Service request line (SR0..SR5) of the protocol, receive and alternate receive events
+ * @return None<br>
+ *
+ * \par<b>Description:</b><br>
+ * Sets up an interrupt driven transaction queue on an I2C master channel.\n\n
+ * The ACK, NACK, arbitration lost, error, stop condition and receive events are enabled and routed to
+ * \a service_request. The NVIC node of the service request has to be enabled by the application, its handler
+ * calls XMC_I2C_CH_QueueHandler(). The channel must not be used with the byte level API while the queue runs.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_I2C_CH_QueueSubmit(), XMC_I2C_CH_QueueHandler()\n\n
+ */
+void XMC_I2C_CH_QueueInit(XMC_I2C_CH_QUEUE_t *const queue, XMC_USIC_CH_t *const channel,
+                          const uint8_t service_request);
+
+/**
+ * @param queue Queue set up by XMC_I2C_CH_QueueInit()
+ * @param transaction Transaction to append, must stay valid until its callback ran
+ * @return XMC_I2C_CH_STATUS_t ERROR for a transaction without messages or with an empty read, OK otherwise<br>
+ *
+ * \par<b>Description:</b><br>
+ * Appends a transaction to the queue and starts it if the bus is idle.\n\n
+ * The status of the transaction is XMC_I2C_CH_TRANSACTION_STATUS_PENDING until it has completed. Transactions run in
+ * submission order, each one closed by a stop condition. The function may be called from the completion callback,
+ * for example to poll a sensor back-to-back.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_I2C_CH_QueueIsIdle()\n\n
+ */
+XMC_I2C_CH_STATUS_t XMC_I2C_CH_QueueSubmit(XMC_I2C_CH_QUEUE_t *const queue,
+                                           XMC_I2C_CH_TRANSACTION_t *const transaction);
+
+/**
+ * @param queue Queue set up by XMC_I2C_CH_QueueInit()
+ * @return None<br>
+ *
+ * \par<b>Description:</b><br>
+ * Moves the running transaction on by one bus step, to be called from the interrupt handler of the service
+ * request.\n\n
+ * Written bytes are sent on the ACK of the previous byte, read bytes are requested one by one with ACK and the
+ * last one with NACK. A NACK stops the transaction with XMC_I2C_CH_TRANSACTION_STATUS_NACK. The completion callback
+ * runs once the stop condition has been seen on the bus, then the next queued transaction starts.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_I2C_CH_QueueSubmit()\n\n
+ */
+void XMC_I2C_CH_QueueHandler(XMC_I2C_CH_QUEUE_t *const queue);
+
+/**
+ * @param queue Queue set up by XMC_I2C_CH_QueueInit()
+ * @return bool true if no transaction is queued or running<br>
+ *
+ * \par<b>Description:</b><br>
+ * Checks whether the queue is empty.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_I2C_CH_QueueSubmit()\n\n
+ */
+__STATIC_INLINE bool XMC_I2C_CH_QueueIsIdle(const XMC_I2C_CH_QUEUE_t *const queue)
+{
+  return (queue->head == NULL);
+}
+
 #ifdef __cplusplus
 }
 #endif
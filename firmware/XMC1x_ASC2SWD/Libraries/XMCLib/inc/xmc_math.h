@@ -63,6 +63,9 @@ extern "C" {
  * -# 32bit signed and unsigned division implementations available for __aeabi_uidiv(), __aeabi_idiv(), __aeabi_uidivmod(), __aeabi_idivmod()
  * -# Divider and CORDIC unit busy status can be checked by XMC_MATH_DIV_IsBusy() and XMC_MATH_CORDIC_IsBusy()
  * -# Individual APIs available to return the result of each non-blocking MATH function
+ * -# Batch APIs keep the CORDIC busy back-to-back over arrays, blocking or driven by the CORDIC end of calculation event
+ * -# Batch APIs overlap the divisions of an array with the CPU's loads and stores
+ * -# XMC_MATH_DIV_UnsignedDivConst() divides by a constant with a multiplication when XMC_MATH_DIV_CONST_RECIPROCAL is defined
  *
  * <B>Note:</B> <br>
  * All non-blocking MATH APIs are not atomic and hence occurence of interrupts during the normal execution of
@@ -108,6 +111,20 @@ typedef int32_t XMC_MATH_Q0_11_t;
 #define XMC_MATH_MINOR_VERSION (0U) /**< Version number : Minor version */
 #define XMC_MATH_PATCH_VERSION (2U) /**< Version number : Patch version */
 
+/* Define XMC_MATH_DIV_CONST_RECIPROCAL to let XMC_MATH_DIV_UnsignedDivConst() multiply with the reciprocal of the
+ * divisor instead of using the DIV unit. Dividends up to XMC_MATH_DIV_CONST_MAX_DIVIDEND take the multiplication. */
+#define XMC_MATH_DIV_CONST_MAX_DIVIDEND (0x7FFFU) /**< Largest dividend divided by the reciprocal of a constant */
+
+/* Tells whether the divisor of XMC_MATH_DIV_UnsignedDivConst() is known at compile time, only then the reciprocal is
+ * folded. Compilers without __builtin_constant_p() always use the DIV unit. */
+#ifndef XMC_MATH_DIV_IS_CONSTANT
+#if defined(__GNUC__)
+#define XMC_MATH_DIV_IS_CONSTANT(x) (__builtin_constant_p(x))
+#else
+#define XMC_MATH_DIV_IS_CONSTANT(x) (0)
+#endif
+#endif
+
 /* Utility macros */
 #define XMC_MATH_Q0_23(x) ((XMC_MATH_Q0_23_t)(((x) >= 0) ? ((x) * (1 << 23) + 0.5) : ((x) * (1 << 23) - 0.5))) /**< Converts the given number to XMC_MATH_Q0_23_t format */
 #define XMC_MATH_Q0_11(x) ((XMC_MATH_Q0_11_t)(((x) >= 0) ? ((x) * (1 << 11) + 0.5) : ((x) * (1 << 11) - 0.5))) /**< Converts the given number to XMC_MATH_Q0_11_t format */
@@ -211,9 +228,31 @@ typedef enum XMC_MATH_CORDIC_MAGNITUDE
   XMC_MATH_CORDIC_MAGNITUDE_DIVBY4 = 2U << MATH_CON_MPS_Pos,              /**< Divide by 4 */
 } XMC_MATH_CORDIC_MAGNITUDE_t;
 
+/**
+ * @brief CORDIC operation of a batch
+ */
+typedef enum XMC_MATH_CORDIC_BATCH_OP
+{
+  XMC_MATH_CORDIC_BATCH_OP_SINCOS = 0U,   /**< Sine and cosine of angles in radians (circular rotation) */
+  XMC_MATH_CORDIC_BATCH_OP_ARCTAN = 1U    /**< atan2 and magnitude of vectors (circular vectoring) */
+} XMC_MATH_CORDIC_BATCH_OP_t;
+
 /*********************************************************************************************************************
  * DATA STRUCTURES
  ********************************************************************************************************************/
+/**
+ * @brief Interrupt driven CORDIC batch, see XMC_MATH_CORDIC_StartBatch()
+ */
+typedef struct XMC_MATH_CORDIC_BATCH
+{
+  XMC_MATH_CORDIC_BATCH_OP_t op;    /**< Operation applied to each element */
+  const int32_t *in_x;              /**< Angles (SINCOS) or x coordinates (ARCTAN) */
+  const int32_t *in_y;              /**< y coordinates (ARCTAN), unused for SINCOS */
+  int32_t *out_a;                   /**< Sines (SINCOS) or angles atan2(y, x) (ARCTAN), may be NULL */
+  int32_t *out_b;                   /**< Cosines (SINCOS) or magnitudes (ARCTAN), may be NULL */
+  uint32_t count;                   /**< Number of elements */
+  volatile uint32_t done;           /**< Number of results stored, updated by XMC_MATH_CORDIC_BatchHandler() */
+} XMC_MATH_CORDIC_BATCH_t;
 
 /*********************************************************************************************************************
  * API Prototypes - General
@@ -1025,6 +1064,198 @@ void XMC_MATH_DIV_UnsignedModNB(uint32_t dividend, uint32_t divisor);
  */
 void XMC_MATH_DIV_SignedModNB(int32_t dividend, int32_t divisor);
 
+/***********************************************************************************************************************
+ * API Prototypes - Batch functions
+ **********************************************************************************************************************/
+/**
+ * @param angle - Array of normalised angles in radians (XMC_MATH_Q0_23_t format)
+ * @param sin   - Array receiving the sines, may be NULL
+ * @param cos   - Array receiving the cosines, may be NULL
+ * @param count - Number of angles
+ *
+ * @return None <BR>
+ *
+ * \par<b>Description:</b><br>
+ * Computes sine and cosine of \e count angles, one CORDIC rotation per angle.
+ *
+ * \par
+ * The CORDIC is programmed to rotation & circular mode once. Each result is read as soon as the CORDIC is done
+ * and the next angle is loaded before the result is stored, so the CORDIC computes element N+1 while the CPU
+ * stores element N. Results are the same as of XMC_MATH_CORDIC_Sin() and XMC_MATH_CORDIC_Cos().
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_MATH_CORDIC_Sin(), XMC_MATH_CORDIC_Cos(), XMC_MATH_CORDIC_StartBatch()\n\n\n
+ *
+ */
+void XMC_MATH_CORDIC_SinCosBatch(const XMC_MATH_Q0_23_t *angle, XMC_MATH_Q0_23_t *sin, XMC_MATH_Q0_23_t *cos,
+                                 uint32_t count);
+
+/**
+ * @param x         - Array of x coordinates (XMC_MATH_Q8_15_t format)
+ * @param y         - Array of y coordinates (XMC_MATH_Q8_15_t format)
+ * @param angle     - Array receiving the angles atan2(y, x) (XMC_MATH_Q0_23_t format), may be NULL
+ * @param magnitude - Array receiving the magnitudes sqrt(x^2 + y^2) (XMC_MATH_Q8_15_t format), may be NULL
+ * @param count     - Number of vectors
+ *
+ * @return None <BR>
+ *
+ * \par<b>Description:</b><br>
+ * Computes arc tangent and magnitude of \e count vectors, one CORDIC vectoring per vector.
+ *
+ * \par
+ * The CORDIC is programmed to vectoring & circular mode with the magnitude prescaler set to 2, so that the
+ * magnitude of any Q8.15 vector fits. The CORDIC gain is removed while the next vector is computed.
+ *
+ * \par
+ * Angles cover the full circle like atan2(): circular vectoring only converges for x >= 0, so a vector with
+ * x < 0 is loaded as (-x, -y) and its result turned by pi. Angles are returned in the 24 bit format of
+ * XMC_MATH_CORDIC_ArcTan(), [-pi, pi) as [0x800000, 0x7FFFFF] with 0x800000 = -pi; for x >= 0 they are the same
+ * as of XMC_MATH_CORDIC_ArcTan(). x must be greater than -256.0, the negation of the smallest Q8.15 value does
+ * not fit.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_MATH_CORDIC_ArcTan(), XMC_MATH_CORDIC_StartBatch()\n\n\n
+ *
+ */
+void XMC_MATH_CORDIC_ArcTanBatch(const XMC_MATH_Q8_15_t *x, const XMC_MATH_Q8_15_t *y, XMC_MATH_Q0_23_t *angle,
+                                 XMC_MATH_Q8_15_t *magnitude, uint32_t count);
+
+/**
+ * @param batch - Batch to run, must stay valid until it is done
+ *
+ * @return None <BR>
+ *
+ * \par<b>Description:</b><br>
+ * Starts an interrupt driven CORDIC batch and returns at once.
+ *
+ * \par
+ * The CORDIC end of calculation event is enabled and the first element is loaded. Each event is served by
+ * XMC_MATH_CORDIC_BatchHandler(), which loads the next element before storing the result. The application
+ * enables MATH0_0_IRQn in the NVIC and calls XMC_MATH_CORDIC_BatchHandler() from its handler.
+ *
+ * \par<b>Note:</b><br>
+ * The CORDIC must not be used by other MATH APIs until XMC_MATH_CORDIC_IsBatchDone() returns true.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_MATH_CORDIC_BatchHandler(), XMC_MATH_CORDIC_IsBatchDone()\n\n\n
+ *
+ */
+void XMC_MATH_CORDIC_StartBatch(XMC_MATH_CORDIC_BATCH_t *const batch);
+
+/**
+ * @return None <BR>
+ *
+ * \par<b>Description:</b><br>
+ * Serves the CORDIC end of calculation event of the batch started by XMC_MATH_CORDIC_StartBatch().
+ *
+ * \par
+ * Disables the event after the last element.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_MATH_CORDIC_StartBatch()\n\n\n
+ *
+ */
+void XMC_MATH_CORDIC_BatchHandler(void);
+
+/**
+ * @param dividend - Array of dividends
+ * @param divisor  - Array of divisors
+ * @param quotient - Array receiving the quotients
+ * @param count    - Number of divisions
+ *
+ * @return None <BR>
+ *
+ * \par<b>Description:</b><br>
+ * Performs \e count unsigned divisions dividend[i] / divisor[i].
+ *
+ * \par
+ * Divider unit is configured for unsigned division once. The operands of the next division are loaded while the
+ * divider works, and the next division is started before the quotient of the previous one is stored.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_MATH_DIV_UnsignedDivNB(), XMC_MATH_DIV_SignedDivBatch()\n\n\n
+ *
+ */
+void XMC_MATH_DIV_UnsignedDivBatch(const uint32_t *dividend, const uint32_t *divisor, uint32_t *quotient,
+                                   uint32_t count);
+
+/**
+ * @param dividend - Array of dividends
+ * @param divisor  - Array of divisors
+ * @param quotient - Array receiving the quotients
+ * @param count    - Number of divisions
+ *
+ * @return None <BR>
+ *
+ * \par<b>Description:</b><br>
+ * Performs \e count signed divisions dividend[i] / divisor[i], pipelined like XMC_MATH_DIV_UnsignedDivBatch().
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_MATH_DIV_SignedDivNB(), XMC_MATH_DIV_UnsignedDivBatch()\n\n\n
+ *
+ */
+void XMC_MATH_DIV_SignedDivBatch(const int32_t *dividend, const int32_t *divisor, int32_t *quotient,
+                                 uint32_t count);
+
+/**
+ * @param dividend - Dividend
+ * @param divisor  - Divisor, a compile time constant other than 0
+ *
+ * @return Quotient dividend / divisor
+ *
+ * \par<b>Description:</b><br>
+ * Divides by a constant divisor.
+ *
+ * \par
+ * Without XMC_MATH_DIV_CONST_RECIPROCAL the division goes to the DIV unit. With it, dividends up to
+ * XMC_MATH_DIV_CONST_MAX_DIVIDEND are multiplied with ceil(2^(15 + s) / divisor) and shifted right by 15 + s,
+ * s being the smallest number with 2^s >= divisor. The quotient is exact for these dividends, larger ones still
+ * use the DIV unit.
+ *
+ * \par<b>Note:</b><br>
+ * The reciprocal is only taken when XMC_MATH_DIV_IS_CONSTANT() finds \e divisor constant, which needs optimization
+ * to inline the call. Otherwise the division goes to the DIV unit, so the reciprocal is never computed at run time.
+ *
+ */
+__STATIC_INLINE uint32_t XMC_MATH_DIV_UnsignedDivConst(uint32_t dividend, const uint32_t divisor)
+{
+#if defined(XMC_MATH_DIV_CONST_RECIPROCAL)
+  uint32_t shift = 15U;
+  uint32_t reciprocal;
+
+  if (XMC_MATH_DIV_IS_CONSTANT(divisor) && (dividend <= XMC_MATH_DIV_CONST_MAX_DIVIDEND))
+  {
+    if (divisor > XMC_MATH_DIV_CONST_MAX_DIVIDEND)
+    {
+      return (0U);
+    }
+    while (((uint32_t) 1U << (shift - 15U)) < divisor)
+    {
+      shift++;
+    }
+    reciprocal = (uint32_t) ((((uint64_t) 1U << shift) + divisor - 1U) / divisor);
+    return ((dividend * reciprocal) >> shift);
+  }
+#endif
+  return (dividend / divisor);
+}
+
+/**
+ * @param batch - Batch started by XMC_MATH_CORDIC_StartBatch()
+ *
+ * @return bool \n
+ * true  - if all results are stored\n
+ * false - if the batch is still running
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_MATH_CORDIC_StartBatch()\n\n\n
+ *
+ */
+__STATIC_INLINE bool XMC_MATH_CORDIC_IsBatchDone(const XMC_MATH_CORDIC_BATCH_t *const batch)
+{
+  return (batch->done >= batch->count);
+}
+
 /**
  * @}
  */
@@ -174,6 +174,25 @@ XMC_PRNG_INIT_STATUS_t XMC_PRNG_Init(const XMC_PRNG_INIT_t *prng);
  */
 void XMC_PRNG_DeInit(void);
 
+/**
+ * @param buffer Destination of the random bytes, any alignment
+ * @param length Number of bytes to fill
+ * @return None
+ *
+ * \par<b>Description: </b><br>
+ * Fills a buffer with pseudo random data <br>
+ *
+ * \par
+ * The function reads the PRNG with the word (16 bit) block size and stores two words per 32 bit write to the
+ * aligned part of the buffer. Leading and trailing bytes outside the aligned part are stored one by one.
+ * CHK.RDV is polled before each read, with two reads per loop iteration. The configured block size is restored
+ * before returning. The PRNG must be initialized by XMC_PRNG_Init().
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_PRNG_GetPseudoRandomNumber()
+ */
+void XMC_PRNG_Fill(void *buffer, uint32_t length);
+
 /*******************************************************************************
  * API DEFINITIONS
  *******************************************************************************/
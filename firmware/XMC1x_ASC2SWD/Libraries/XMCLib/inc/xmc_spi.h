@@ -263,6 +263,19 @@ typedef struct XMC_SPI_CH_CONFIG
   XMC_USIC_CH_PARITY_MODE_t parity_mode;          /**< Enable parity check for transmit and received data */
 } XMC_SPI_CH_CONFIG_t;
 
+/**
+ * State of a buffered full duplex transfer, see XMC_SPI_CH_StartTransfer()
+ */
+typedef struct XMC_SPI_CH_TRANSFER
+{
+  XMC_USIC_CH_t *channel;     /**< USIC channel in SPI master mode with transmit and receive FIFO */
+  const uint8_t *tx;          /**< Words to send, NULL sends FFH */
+  uint8_t *rx;                /**< Received words, NULL discards them */
+  uint32_t length;            /**< Number of words of the transfer */
+  uint32_t tx_count;          /**< Words put into the transmit FIFO */
+  volatile uint32_t rx_count; /**< Words taken from the receive FIFO */
+} XMC_SPI_CH_TRANSFER_t;
+
 /*********************************************************************************************************************
  * API PROTOTYPES
  ********************************************************************************************************************/
@@ -455,6 +468,80 @@ __STATIC_INLINE void XMC_SPI_CH_Receive(XMC_USIC_CH_t *const channel, const XMC_
  */
 uint16_t XMC_SPI_CH_GetReceivedData(XMC_USIC_CH_t *const channel);
 
+/**
+ * @param channel A constant pointer to XMC_USIC_CH_t, pointing to the USIC channel base address.
+ * @param tx Words to send, NULL sends FFH (read only transfer)
+ * @param rx Buffer for the received words, NULL discards them (write only transfer)
+ * @param length Number of 8 bit words to transfer
+ *
+ * @return None
+ *
+ * \par<b>Description:</b><br>
+ * Transfers a block in standard full duplex mode and waits until the last word has been received.\n\n
+ * The transmit FIFO is kept full while the receive FIFO is drained in bursts, so the shift clock runs without gaps
+ * between words. No more words are put into the transmit FIFO than the receive FIFO can hold, the receive FIFO can
+ * therefore not overflow. Both FIFOs must be configured with XMC_USIC_CH_TXFIFO_Configure() and
+ * XMC_USIC_CH_RXFIFO_Configure(), the word length must be 8 bit. The slave select line is left to the caller.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_SPI_CH_StartTransfer(), XMC_SPI_CH_EnableSlaveSelect()
+ */
+void XMC_SPI_CH_Transfer(XMC_USIC_CH_t *const channel, const uint8_t *tx, uint8_t *rx, const uint32_t length);
+
+/**
+ * @param transfer Transfer state, must stay valid until the transfer is done
+ * @param channel A constant pointer to XMC_USIC_CH_t, pointing to the USIC channel base address.
+ * @param tx Words to send, NULL sends FFH (read only transfer)
+ * @param rx Buffer for the received words, NULL discards them (write only transfer)
+ * @param length Number of 8 bit words to transfer
+ *
+ * @return None
+ *
+ * \par<b>Description:</b><br>
+ * Starts a buffered full duplex transfer without waiting for it.\n\n
+ * The transmit FIFO is filled and the receive FIFO limit is set so that the standard receive buffer event occurs
+ * once about half of the words in flight have been received. XMC_SPI_CH_TransferHandler() moves the transfer on,
+ * either called from the receive FIFO interrupt or polled. For the interrupt driven use the standard receive buffer
+ * event has to be enabled with XMC_USIC_CH_RXFIFO_EnableEvent() and routed to the NVIC with
+ * XMC_USIC_CH_RXFIFO_SetInterruptNodePointer(). The FIFO requirements of XMC_SPI_CH_Transfer() apply.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_SPI_CH_TransferHandler(), XMC_SPI_CH_IsTransferDone()
+ */
+void XMC_SPI_CH_StartTransfer(XMC_SPI_CH_TRANSFER_t *const transfer, XMC_USIC_CH_t *const channel,
+                              const uint8_t *tx, uint8_t *rx, const uint32_t length);
+
+/**
+ * @param transfer Transfer started by XMC_SPI_CH_StartTransfer()
+ *
+ * @return None
+ *
+ * \par<b>Description:</b><br>
+ * Drains the receive FIFO, refills the transmit FIFO and sets the next receive FIFO limit.\n\n
+ * Call it from the receive FIFO interrupt handler or poll it until XMC_SPI_CH_IsTransferDone() returns true.
+ * The function rechecks the filling level after a new limit is set, so no event is lost between both.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_SPI_CH_StartTransfer(), XMC_SPI_CH_IsTransferDone()
+ */
+void XMC_SPI_CH_TransferHandler(XMC_SPI_CH_TRANSFER_t *const transfer);
+
+/**
+ * @param transfer Transfer started by XMC_SPI_CH_StartTransfer()
+ *
+ * @return bool true once the last word has been received
+ *
+ * \par<b>Description:</b><br>
+ * Checks whether a buffered transfer is complete. The slave select line may be disabled afterwards.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_SPI_CH_TransferHandler()
+ */
+__STATIC_INLINE bool XMC_SPI_CH_IsTransferDone(const XMC_SPI_CH_TRANSFER_t *const transfer)
+{
+  return (transfer->rx_count == transfer->length);
+}
+
 /**
  * @param channel A constant pointer to XMC_USIC_CH_t, pointing to the USIC channel base address.
  *
@@ -472,6 +472,17 @@ typedef struct XMC_USIC_CH
   __O  uint32_t  IN[32];		/**< Transmit FIFO input register*/
 } XMC_USIC_CH_t;
 
+/**
+ * Fractional divider setting of the baud rate generator, as calculated by XMC_USIC_CH_GetBaudrateDivider().
+ * Dividers for clocks and baud rates known at build time can be kept in a constant table and applied with
+ * XMC_USIC_CH_SetBaudrateDivider().
+ */
+typedef struct XMC_USIC_CH_BAUDRATE_DIVIDER
+{
+  uint16_t step;	/**< FDR.STEP, fractional divider step (1 to 1023) */
+  uint16_t pdiv;	/**< BRG.PDIV, divider register value (0 to 1023), divide factor is pdiv + 1 */
+} XMC_USIC_CH_BAUDRATE_DIVIDER_t;
+
 
 /*Anonymous structure/union guard end*/
 #if defined(__CC_ARM)
@@ -580,6 +591,53 @@ void XMC_USIC_CH_Disable(XMC_USIC_CH_t *const channel);
  */
 XMC_USIC_CH_STATUS_t XMC_USIC_CH_SetBaudrate(XMC_USIC_CH_t *const channel, uint32_t rate, uint32_t oversampling);
 
+/**
+ * @param  peripheral_clock Peripheral clock frequency in Hz.
+ * @param  rate Desired baudrate. \b Range: minimum value = 100, see XMC_USIC_CH_SetBaudrate().
+ * @param  oversampling Required oversampling. \b Range: 1 to 32.
+ * @param  divider Calculated FDR->STEP and BRG->PDIV values.
+ * @return Status indicating whether a divider exists.\n
+ * 			\b Range: @ref XMC_USIC_CH_STATUS_OK if \a divider is valid,
+ * 					  @ref XMC_USIC_CH_STATUS_ERROR if desired baudrate or oversampling is invalid.
+ *
+ * \par<b>Description</b><br>
+ * Calculates the baud rate generator setting used by XMC_USIC_CH_SetBaudrate(), without accessing the channel. \n\n
+ * Of all STEP values, the one that leaves the smallest fraction in the PDIV division is chosen. Only the smallest
+ * STEP of each PDIV value can be the best one, so the search walks the PDIV values and needs a constant number of
+ * divisions. The number of loop iterations is about fperiph / (rate * oversampling).
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_USIC_CH_SetBaudrate(), XMC_USIC_CH_SetBaudrateDivider() \n\n\n
+ */
+XMC_USIC_CH_STATUS_t XMC_USIC_CH_GetBaudrateDivider(uint32_t peripheral_clock, uint32_t rate, uint32_t oversampling,
+                                                    XMC_USIC_CH_BAUDRATE_DIVIDER_t *const divider);
+
+/**
+ * @param  channel Pointer to USIC channel handler of type @ref XMC_USIC_CH_t \n
+ * 				   \b Range: @ref XMC_USIC0_CH0, @ref XMC_USIC0_CH1 to @ref XMC_USIC2_CH1 based on device support.
+ * @param  divider Baud rate generator setting, see XMC_USIC_CH_GetBaudrateDivider().
+ * @param  oversampling Required oversampling. \b Range: 1 to 32.
+ * @return None
+ *
+ * \par<b>Description</b><br>
+ * Configures the baudrate of the USIC channel from a precalculated divider. \n\n
+ * Same register setting as XMC_USIC_CH_SetBaudrate() without the calculation, for baud rate switches at run time.
+ *
+ * \par<b>Related APIs:</b><BR>
+ * XMC_USIC_CH_SetBaudrate(), XMC_USIC_CH_GetBaudrateDivider() \n\n\n
+ */
+__STATIC_INLINE void XMC_USIC_CH_SetBaudrateDivider(XMC_USIC_CH_t *const channel,
+                                                    const XMC_USIC_CH_BAUDRATE_DIVIDER_t *const divider,
+                                                    uint32_t oversampling)
+{
+  channel->FDR = XMC_USIC_CH_BRG_CLOCK_DIVIDER_MODE_FRACTIONAL |
+                 ((uint32_t)divider->step << USIC_CH_FDR_STEP_Pos);
+
+  channel->BRG = (channel->BRG & ~(USIC_CH_BRG_DCTQ_Msk | USIC_CH_BRG_PDIV_Msk)) |
+                 ((oversampling - 1U) << USIC_CH_BRG_DCTQ_Pos) |
+                 ((uint32_t)divider->pdiv << USIC_CH_BRG_PDIV_Pos);
+}
+
 /**
  * @param  channel Pointer to USIC channel handler of type @ref XMC_USIC_CH_t \n
  * 				   \b Range: @ref XMC_USIC0_CH0, @ref XMC_USIC0_CH1 to @ref XMC_USIC2_CH1 based on device support.
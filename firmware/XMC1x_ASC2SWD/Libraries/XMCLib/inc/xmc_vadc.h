@@ -1096,6 +1096,24 @@ typedef struct XMC_VADC_RESULT_CONFIG
 #elif defined(__TASKING__)
   #pragma warning restore
 #endif
+
+#if (XMC_VADC_GROUP_AVAILABLE == 1U)
+/**
+ * Result stream of a group result FIFO. Results are copied by XMC_VADC_GROUP_StreamHandler() (single producer) into
+ * a ring buffer read by XMC_VADC_GROUP_StreamRead() (single consumer). Use XMC_VADC_GROUP_StreamInit() to set it up.
+ */
+typedef struct XMC_VADC_STREAM
+{
+  XMC_VADC_GROUP_t *group_ptr;   /**< Group of the result FIFO */
+  uint32_t tail;                 /**< FIFO output register, read by the handler */
+  uint32_t *buffer;              /**< Ring storage, complete GxRESy words (result, channel number and flags) */
+  uint32_t mask;                 /**< Ring size - 1, the size is a power of two */
+  volatile uint32_t write;       /**< Free running count of stored results, written by the handler only */
+  volatile uint32_t read;        /**< Free running count of consumed results, written by the consumer only */
+  volatile uint32_t overruns;    /**< Results dropped because the ring was full */
+} XMC_VADC_STREAM_t;
+#endif
+
 /*********************************************************************************************************************
  * static inline functions
  ********************************************************************************************************************/
@@ -3768,6 +3786,101 @@ __STATIC_INLINE bool XMC_VADC_GROUP_IsResultRegisterInFifo(XMC_VADC_GROUP_t *con
              ((res_reg) < XMC_VADC_NUM_RESULT_REGISTERS))
   return( (bool)(group_ptr->RCR[res_reg] & (uint32_t)VADC_G_RCR_FEN_Msk));
 }
+
+/**
+ *
+ * @param stream    Stream to initialize
+ * @param group_ptr Constant pointer to the VADC group
+ * @param head      Result register the channels write to, head of the FIFO<BR>
+ *                  <BR>Range: [0x1 to 0xF]
+ * @param depth     Number of result registers in the FIFO, head included<BR>
+ *                  <BR>Range: [0x2 to head + 1]
+ * @param buffer    Ring storage of \b size words
+ * @param size      Number of results the ring holds, a power of two
+ * @param sr        Service request line of the result event
+ * @return
+ *  XMC_VADC_STATUS_t XMC_VADC_STATUS_ERROR if \b depth, \b head or \b size are out of range.
+ *
+ * \par<b>Description:</b><br>
+ * Sets up a result FIFO streamed into an SRAM ring buffer.<BR>\n
+ * Registers head - depth + 1 to head - 1 are chained into a FIFO behind \b head. The result event of the FIFO
+ * output register (the tail) is enabled and routed to \b sr. The service request handler calls
+ * XMC_VADC_GROUP_StreamHandler(), which moves all results in the FIFO into the ring at once, so the FIFO only has
+ * to hold the results converted during the interrupt latency. The channels to be streamed are bound to \b head
+ * by the application, and the service request line is enabled in the NVIC by the application.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_VADC_GROUP_StreamHandler(), XMC_VADC_GROUP_StreamRead(), XMC_VADC_GROUP_AddResultToFifo()
+ */
+XMC_VADC_STATUS_t XMC_VADC_GROUP_StreamInit(XMC_VADC_STREAM_t *const stream,
+                                            XMC_VADC_GROUP_t *const group_ptr,
+                                            const uint32_t head,
+                                            const uint32_t depth,
+                                            uint32_t *const buffer,
+                                            const uint32_t size,
+                                            const XMC_VADC_SR_t sr);
+
+/**
+ *
+ * @param stream Stream set up by XMC_VADC_GROUP_StreamInit()
+ * @return
+ *    None
+ *
+ * \par<b>Description:</b><br>
+ * Drains the result FIFO of \b stream into its ring buffer.<BR>\n
+ * Reads the FIFO output register until its valid flag is clear. Results that find the ring full are dropped and
+ * counted in \b overruns. To be called from the handler of the result event service request.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_VADC_GROUP_StreamRead()
+ */
+void XMC_VADC_GROUP_StreamHandler(XMC_VADC_STREAM_t *const stream);
+
+/**
+ *
+ * @param stream  Stream set up by XMC_VADC_GROUP_StreamInit()
+ * @param results Array receiving up to \b max GxRESy words
+ * @param max     Size of \b results
+ * @return
+ *  uint32_t Number of results copied.
+ *
+ * \par<b>Description:</b><br>
+ * Copies the oldest results of the ring buffer to \b results and frees them.<BR>\n
+ * Lock free against XMC_VADC_GROUP_StreamHandler(), as long as one consumer reads the stream. The result and the
+ * channel number of a word are found in its VADC_G_RES_RESULT and VADC_G_RES_CHNR fields.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_VADC_GROUP_StreamGetLevel(), XMC_VADC_GROUP_StreamGetOverruns()
+ */
+uint32_t XMC_VADC_GROUP_StreamRead(XMC_VADC_STREAM_t *const stream, uint32_t *const results, const uint32_t max);
+
+/**
+ *
+ * @param stream Stream set up by XMC_VADC_GROUP_StreamInit()
+ * @return
+ *  uint32_t Number of results waiting in the ring buffer.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_VADC_GROUP_StreamRead()
+ */
+__STATIC_INLINE uint32_t XMC_VADC_GROUP_StreamGetLevel(const XMC_VADC_STREAM_t *const stream)
+{
+  return (stream->write - stream->read);
+}
+
+/**
+ *
+ * @param stream Stream set up by XMC_VADC_GROUP_StreamInit()
+ * @return
+ *  uint32_t Number of results dropped because the ring buffer was full.
+ *
+ * \par<b>Related APIs:</b><br>
+ * XMC_VADC_GROUP_StreamRead()
+ */
+__STATIC_INLINE uint32_t XMC_VADC_GROUP_StreamGetOverruns(const XMC_VADC_STREAM_t *const stream)
+{
+  return (stream->overruns);
+}
 #endif
 
 #ifdef __cplusplus
@@ -769,6 +769,119 @@ XMC_CCU4_STATUS_t XMC_CCU4_SLICE_GetLastCapturedTimerValue(const XMC_CCU4_SLICE_
   return retval;
 }
 
+/* Stores one captured value of a drained capture register set */
+static void XMC_CCU4_lStoreCapture(XMC_CCU4_CAPTURE_BUFFER_t *const buffer, const uint32_t value)
+{
+  if (buffer->count < buffer->size)
+  {
+    buffer->values[buffer->count] = value & ((uint32_t)CCU4_CC4_CV_CAPTV_Msk | (uint32_t)CCU4_CC4_CV_FPCV_Msk);
+    buffer->count++;
+  }
+  else
+  {
+    buffer->lost++;
+  }
+}
+
+/* Drains all full capture registers of a group of slices into timestamp buffers */
+void XMC_CCU4_DrainCaptures(XMC_CCU4_CAPTURE_BUFFER_t *const buffers, const uint32_t num_buffers)
+{
+  XMC_CCU4_CAPTURE_BUFFER_t *buffer;
+  const XMC_CCU4_SLICE_t *slice;
+  uint32_t cap;
+  uint32_t n;
+  uint8_t i;
+  uint8_t start;
+  uint8_t end;
+
+  for (n = 0U; n < num_buffers; n++)
+  {
+    buffer = &buffers[n];
+    slice = buffer->slice;
+
+    XMC_ASSERT("XMC_CCU4_DrainCaptures:Invalid Slice Pointer", XMC_CCU4_CHECK_SLICE_PTR(slice));
+
+#if UC_FAMILY != XMC4
+    if (XMC_CCU4_SLICE_IsExtendedCapReadEnabled(slice))
+    {
+      /* The set reads like a FIFO, oldest value first */
+      cap = XMC_CCU4_SLICE_GetCapturedValueFromFifo(slice, buffer->set);
+      while (cap & (uint32_t)CCU4_CC4_ECRD0_FFL_Msk)
+      {
+        if (cap & (uint32_t)CCU4_CC4_ECRD0_LCV_Msk)
+        {
+          buffer->lost++;
+        }
+        XMC_CCU4_lStoreCapture(buffer, cap);
+        cap = XMC_CCU4_SLICE_GetCapturedValueFromFifo(slice, buffer->set);
+      }
+      continue;
+    }
+#endif
+
+    /* A capture moves the older value one register down, so lower registers are older */
+    start = (buffer->set == XMC_CCU4_SLICE_CAP_REG_SET_HIGH) ? (((uint8_t) XMC_CCU4_NUM_SLICES_PER_MODULE) >> 1U) : 0U;
+    end   = start + (((uint8_t) XMC_CCU4_NUM_SLICES_PER_MODULE) >> 1U);
+    for (i = start; i < end; i++)
+    {
+      cap = slice->CV[i];
+      if (cap & CCU4_CC4_CV_FFL_Msk)
+      {
+        XMC_CCU4_lStoreCapture(buffer, cap);
+      }
+    }
+  }
+}
+
+/* Removes the oldest values of a timestamp buffer, keeping the rest in order */
+static void XMC_CCU4_lDropCaptures(XMC_CCU4_CAPTURE_BUFFER_t *const buffer, const uint32_t num_values)
+{
+  uint32_t i;
+
+  for (i = num_values; i < buffer->count; i++)
+  {
+    buffer->values[i - num_values] = buffer->values[i];
+  }
+  buffer->count -= num_values;
+}
+
+/* Derives period and pulse width of a PWM input from two drained capture sets */
+uint32_t XMC_CCU4_GetPwmMeasurements(XMC_CCU4_CAPTURE_BUFFER_t *const period_buffer,
+                                     XMC_CCU4_CAPTURE_BUFFER_t *const pulse_buffer,
+                                     XMC_CCU4_PWM_MEASUREMENT_t *const results,
+                                     const uint32_t max)
+{
+  uint32_t count;
+  uint32_t i;
+
+  /* Period i starts with period start capture i and is closed by capture i + 1 */
+  count = 0U;
+  if (period_buffer->count > 0U)
+  {
+    count = period_buffer->count - 1U;
+  }
+  if (count > pulse_buffer->count)
+  {
+    count = pulse_buffer->count;
+  }
+  if (count > max)
+  {
+    count = max;
+  }
+
+  for (i = 0U; i < count; i++)
+  {
+    results[i].period = (uint16_t) (period_buffer->values[i + 1U] & (uint32_t)CCU4_CC4_CV_CAPTV_Msk);
+    results[i].pulse  = (uint16_t) (pulse_buffer->values[i] & (uint32_t)CCU4_CC4_CV_CAPTV_Msk);
+  }
+
+  /* The start of the open period, and its pulse end if already captured, stay for the next call */
+  XMC_CCU4_lDropCaptures(period_buffer, count);
+  XMC_CCU4_lDropCaptures(pulse_buffer, count);
+
+  return count;
+}
+
 /* Retrieves timer capture value from a FIFO made of capture registers */
 #if UC_FAMILY == XMC4
 int32_t XMC_CCU4_GetCapturedValueFromFifo(const XMC_CCU4_MODULE_t *const module, const uint8_t slice_number)
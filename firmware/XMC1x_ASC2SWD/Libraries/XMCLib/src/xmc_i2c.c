@@ -40,6 +40,22 @@
 #define WORDLENGTH              (7U)        /**< Word length */
 #define SET_TDV                 (1U)		/**< Transmission data valid */
 #define XMC_I2C_10BIT_ADDR_MASK (0xF800U)   /**< Address mask for 10-bit mode */
+
+#define XMC_I2C_CH_QUEUE_STATE_IDLE    (0U)  /**< No transaction on the bus */
+#define XMC_I2C_CH_QUEUE_STATE_ADDRESS (1U)  /**< (Repeated) start and address sent, waiting for the ACK */
+#define XMC_I2C_CH_QUEUE_STATE_WRITE   (2U)  /**< Data byte sent, waiting for the ACK */
+#define XMC_I2C_CH_QUEUE_STATE_READ    (3U)  /**< Data byte requested, waiting for it */
+#define XMC_I2C_CH_QUEUE_STATE_STOP    (4U)  /**< Stop sent, waiting for the stop condition */
+
+/**< Status flags evaluated by XMC_I2C_CH_QueueHandler() */
+#define XMC_I2C_CH_QUEUE_FLAGS ((uint32_t)XMC_I2C_CH_STATUS_FLAG_ACK_RECEIVED | \
+                                (uint32_t)XMC_I2C_CH_STATUS_FLAG_NACK_RECEIVED | \
+                                (uint32_t)XMC_I2C_CH_STATUS_FLAG_ARBITRATION_LOST | \
+                                (uint32_t)XMC_I2C_CH_STATUS_FLAG_ERROR | \
+                                (uint32_t)XMC_I2C_CH_STATUS_FLAG_WRONG_TDF_CODE_FOUND | \
+                                (uint32_t)XMC_I2C_CH_STATUS_FLAG_STOP_CONDITION_RECEIVED | \
+                                (uint32_t)XMC_I2C_CH_STATUS_FLAG_RECEIVE_INDICATION | \
+                                (uint32_t)XMC_I2C_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION)
 /*******************************************************************************
  * ENUMS
  *******************************************************************************/
@@ -67,6 +83,14 @@ typedef enum XMC_I2C_CH_CLOCK_OVERSAMPLING
   XMC_I2C_CH_CLOCK_OVERSAMPLING_FAST     = 25U
 } XMC_I2C_CH_CLOCK_OVERSAMPLINGS_t;
 
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ *******************************************************************************/
+static void XMC_I2C_CH_lStartMessage(XMC_I2C_CH_QUEUE_t *const queue, const bool restart);
+static void XMC_I2C_CH_lNextMessage(XMC_I2C_CH_QUEUE_t *const queue);
+static void XMC_I2C_CH_lRequest(XMC_I2C_CH_QUEUE_t *const queue, const XMC_I2C_CH_MSG_t *const msg);
+static void XMC_I2C_CH_lComplete(XMC_I2C_CH_QUEUE_t *const queue, const XMC_I2C_CH_TRANSACTION_STATUS_t status);
+
 /*******************************************************************************
  * API IMPLEMENTATION
  *******************************************************************************/
@@ -366,3 +390,225 @@ void XMC_I2C_CH_DisableEvent(XMC_USIC_CH_t *const channel, uint32_t event)
     channel->PCR_IICMode &= ~event;
   }
 }
+
+/* Enables the events of the transaction queue and routes them to one service request */
+void XMC_I2C_CH_QueueInit(XMC_I2C_CH_QUEUE_t *const queue, XMC_USIC_CH_t *const channel,
+                          const uint8_t service_request)
+{
+  XMC_ASSERT("XMC_I2C_CH_QueueInit: receive FIFO not supported", (channel->RBCTR & USIC_CH_RBCTR_SIZE_Msk) == 0U);
+
+  queue->channel = channel;
+  queue->head = NULL;
+  queue->tail = NULL;
+  queue->state = XMC_I2C_CH_QUEUE_STATE_IDLE;
+
+  XMC_USIC_CH_SetInterruptNodePointer(channel, XMC_USIC_CH_INTERRUPT_NODE_POINTER_PROTOCOL, (uint32_t)service_request);
+  XMC_USIC_CH_SetInterruptNodePointer(channel, XMC_USIC_CH_INTERRUPT_NODE_POINTER_RECEIVE, (uint32_t)service_request);
+  XMC_USIC_CH_SetInterruptNodePointer(channel, XMC_USIC_CH_INTERRUPT_NODE_POINTER_ALTERNATE_RECEIVE,
+                                      (uint32_t)service_request);
+
+  channel->PSCR = XMC_I2C_CH_QUEUE_FLAGS;
+  XMC_I2C_CH_EnableEvent(channel, (uint32_t)XMC_I2C_CH_EVENT_ACK | (uint32_t)XMC_I2C_CH_EVENT_NACK |
+                                  (uint32_t)XMC_I2C_CH_EVENT_ARBITRATION_LOST | (uint32_t)XMC_I2C_CH_EVENT_ERROR |
+                                  (uint32_t)XMC_I2C_CH_EVENT_STOP_CONDITION_RECEIVED);
+  XMC_I2C_CH_EnableEvent(channel, (uint32_t)XMC_I2C_CH_EVENT_STANDARD_RECEIVE |
+                                  (uint32_t)XMC_I2C_CH_EVENT_ALTERNATIVE_RECEIVE);
+}
+
+/* Appends a transaction to the queue, starts it on an idle bus */
+XMC_I2C_CH_STATUS_t XMC_I2C_CH_QueueSubmit(XMC_I2C_CH_QUEUE_t *const queue,
+                                           XMC_I2C_CH_TRANSACTION_t *const transaction)
+{
+  uint32_t primask;
+  uint32_t i;
+
+  if (transaction->count == 0U)
+  {
+    return XMC_I2C_CH_STATUS_ERROR;
+  }
+  for (i = 0U; i < transaction->count; i++)
+  {
+    if ((transaction->msgs[i].command == XMC_I2C_CH_CMD_READ) && (transaction->msgs[i].length == 0U))
+    {
+      return XMC_I2C_CH_STATUS_ERROR;
+    }
+  }
+
+  transaction->status = XMC_I2C_CH_TRANSACTION_STATUS_PENDING;
+  transaction->next = NULL;
+
+  /* the handler must not see a half linked queue */
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if (queue->head == NULL)
+  {
+    queue->head = transaction;
+  }
+  else
+  {
+    queue->tail->next = transaction;
+  }
+  queue->tail = transaction;
+
+  if (queue->state == XMC_I2C_CH_QUEUE_STATE_IDLE)
+  {
+    queue->msg = 0U;
+    XMC_I2C_CH_lStartMessage(queue, false);
+  }
+  __set_PRIMASK(primask);
+
+  return XMC_I2C_CH_STATUS_OK;
+}
+
+/* Moves the running transaction on by one bus step */
+void XMC_I2C_CH_QueueHandler(XMC_I2C_CH_QUEUE_t *const queue)
+{
+  XMC_USIC_CH_t *const channel = queue->channel;
+  XMC_I2C_CH_TRANSACTION_t *const transaction = queue->head;
+  XMC_I2C_CH_MSG_t *msg;
+  uint32_t psr;
+
+  psr = channel->PSR_IICMode & XMC_I2C_CH_QUEUE_FLAGS;
+  channel->PSCR = psr;
+
+  if ((transaction == NULL) || (queue->state == XMC_I2C_CH_QUEUE_STATE_IDLE))
+  {
+    return;
+  }
+  msg = &transaction->msgs[queue->msg];
+
+  if ((psr & (uint32_t)XMC_I2C_CH_STATUS_FLAG_ARBITRATION_LOST) != 0U)
+  {
+    /* Another master owns the bus, it sends the stop condition */
+    XMC_I2C_CH_lComplete(queue, XMC_I2C_CH_TRANSACTION_STATUS_ERROR);
+  }
+  else if (queue->state == XMC_I2C_CH_QUEUE_STATE_STOP)
+  {
+    if ((psr & (uint32_t)XMC_I2C_CH_STATUS_FLAG_STOP_CONDITION_RECEIVED) != 0U)
+    {
+      XMC_I2C_CH_lComplete(queue, queue->result);
+    }
+  }
+  else if ((psr & ((uint32_t)XMC_I2C_CH_STATUS_FLAG_NACK_RECEIVED | (uint32_t)XMC_I2C_CH_STATUS_FLAG_ERROR)) != 0U)
+  {
+    queue->result = ((psr & (uint32_t)XMC_I2C_CH_STATUS_FLAG_NACK_RECEIVED) != 0U) ?
+                    XMC_I2C_CH_TRANSACTION_STATUS_NACK : XMC_I2C_CH_TRANSACTION_STATUS_ERROR;
+    XMC_I2C_CH_MasterStop(channel);
+    queue->state = XMC_I2C_CH_QUEUE_STATE_STOP;
+  }
+  else if (queue->state == XMC_I2C_CH_QUEUE_STATE_READ)
+  {
+    if ((psr & ((uint32_t)XMC_I2C_CH_STATUS_FLAG_RECEIVE_INDICATION |
+                (uint32_t)XMC_I2C_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION)) != 0U)
+    {
+      msg->data[queue->pos] = XMC_I2C_CH_GetReceivedData(channel);
+      queue->pos++;
+      if (queue->pos < msg->length)
+      {
+        XMC_I2C_CH_lRequest(queue, msg);
+      }
+      else
+      {
+        XMC_I2C_CH_lNextMessage(queue);
+      }
+    }
+  }
+  else if ((psr & (uint32_t)XMC_I2C_CH_STATUS_FLAG_ACK_RECEIVED) != 0U)
+  {
+    if (msg->command == XMC_I2C_CH_CMD_READ)
+    {
+      /* Address acknowledged, the slave sends from now on */
+      queue->state = XMC_I2C_CH_QUEUE_STATE_READ;
+      XMC_I2C_CH_lRequest(queue, msg);
+    }
+    else if (queue->pos < msg->length)
+    {
+      queue->state = XMC_I2C_CH_QUEUE_STATE_WRITE;
+      XMC_I2C_CH_MasterTransmit(channel, msg->data[queue->pos]);
+      queue->pos++;
+    }
+    else
+    {
+      XMC_I2C_CH_lNextMessage(queue);
+    }
+  }
+  else
+  {
+    /* Event of an earlier step */
+  }
+}
+
+/*******************************************************************************
+ * LOCAL FUNCTIONS
+ *******************************************************************************/
+/* Sends the (repeated) start and address of the current message */
+static void XMC_I2C_CH_lStartMessage(XMC_I2C_CH_QUEUE_t *const queue, const bool restart)
+{
+  const XMC_I2C_CH_MSG_t *const msg = &queue->head->msgs[queue->msg];
+
+  queue->pos = 0U;
+  queue->state = XMC_I2C_CH_QUEUE_STATE_ADDRESS;
+  if (restart)
+  {
+    XMC_I2C_CH_MasterRepeatedStart(queue->channel, msg->address, msg->command);
+  }
+  else
+  {
+    XMC_I2C_CH_MasterStart(queue->channel, msg->address, msg->command);
+  }
+}
+
+/* Continues with the next message after a repeated start, or stops after the last one */
+static void XMC_I2C_CH_lNextMessage(XMC_I2C_CH_QUEUE_t *const queue)
+{
+  queue->msg++;
+  if (queue->msg < queue->head->count)
+  {
+    XMC_I2C_CH_lStartMessage(queue, true);
+  }
+  else
+  {
+    queue->result = XMC_I2C_CH_TRANSACTION_STATUS_DONE;
+    XMC_I2C_CH_MasterStop(queue->channel);
+    queue->state = XMC_I2C_CH_QUEUE_STATE_STOP;
+  }
+}
+
+/* Requests the next byte of a read, the last one is not acknowledged */
+static void XMC_I2C_CH_lRequest(XMC_I2C_CH_QUEUE_t *const queue, const XMC_I2C_CH_MSG_t *const msg)
+{
+  if ((queue->pos + 1U) == msg->length)
+  {
+    XMC_I2C_CH_MasterReceiveNack(queue->channel);
+  }
+  else
+  {
+    XMC_I2C_CH_MasterReceiveAck(queue->channel);
+  }
+}
+
+/* Reports the running transaction and starts the next one */
+static void XMC_I2C_CH_lComplete(XMC_I2C_CH_QUEUE_t *const queue, const XMC_I2C_CH_TRANSACTION_STATUS_t status)
+{
+  XMC_I2C_CH_TRANSACTION_t *const transaction = queue->head;
+
+  queue->head = transaction->next;
+  if (queue->head == NULL)
+  {
+    queue->tail = NULL;
+  }
+  queue->state = XMC_I2C_CH_QUEUE_STATE_IDLE;
+  transaction->status = status;
+
+  if (transaction->callback != NULL)
+  {
+    transaction->callback(transaction);
+  }
+
+  /* A transaction submitted by the callback may have been started already */
+  if ((queue->head != NULL) && (queue->state == XMC_I2C_CH_QUEUE_STATE_IDLE))
+  {
+    queue->msg = 0U;
+    XMC_I2C_CH_lStartMessage(queue, false);
+  }
+}
@@ -43,6 +43,12 @@
 #define XMC_MATH_SIGNED_DIVISION                      ((uint32_t) 0 << MATH_DIVCON_USIGN_Pos)
 /* Unsigned division is selected */
 #define XMC_MATH_UNSIGNED_DIVISION                    ((uint32_t) 1 << MATH_DIVCON_USIGN_Pos)
+/* Shift after multiplying a magnitude prescaled by 2 with XMC_MATH_RECIPROC_CIRCULAR_GAIN_IN_Q023 */
+#define XMC_MATH_BATCH_MAGNITUDE_SHIFT                (22U)
+/* Normalised angle pi in XMC_MATH_Q0_23_t format, the same as -pi in the 24 bit CORRZ result */
+#define XMC_MATH_BATCH_PI_IN_Q0_23                    (0x800000U)
+/* 24 bit CORRZ result */
+#define XMC_MATH_BATCH_ANGLE_MASK                     (0xFFFFFFU)
 
 /*********************************************************************************************************************
  * ENUMS
@@ -51,6 +57,8 @@
 /*********************************************************************************************************************
  * GLOBAL DATA
  ********************************************************************************************************************/
+/* Batch served by XMC_MATH_CORDIC_BatchHandler() */
+static XMC_MATH_CORDIC_BATCH_t *xmc_math_cordic_batch;
 
 /*********************************************************************************************************************
  * DATA STRUCTURES
@@ -59,6 +67,60 @@
 /*********************************************************************************************************************
  * LOCAL ROUTINES
  ********************************************************************************************************************/
+/* Starts a rotation of the unit vector by angle, CON is already programmed */
+__STATIC_INLINE void XMC_MATH_CORDIC_lLoadRotation(XMC_MATH_Q0_23_t angle_in_radians)
+{
+  MATH->CORDZ = ((uint32_t) angle_in_radians) << MATH_CORDZ_DATA_Pos;
+  MATH->CORDY = 0U;  /* Clear register */
+  MATH->CORDX = XMC_MATH_RECIPROC_CIRCULAR_GAIN_IN_Q023 << MATH_CORDX_DATA_Pos;
+}
+
+/* Starts a vectoring of (x, y), CON is already programmed. Circular vectoring only converges for x >= 0, so a
+ * vector with x < 0 is turned by pi first and XMC_MATH_CORDIC_lAngle() turns the result back. */
+__STATIC_INLINE void XMC_MATH_CORDIC_lLoadVectoring(XMC_MATH_Q8_15_t x, XMC_MATH_Q8_15_t y)
+{
+  if (x < 0)
+  {
+    x = -x;
+    y = -y;
+  }
+  MATH->CORDZ = 0U;  /* Clear register */
+  MATH->CORDY = ((uint32_t) y) << MATH_CORDY_DATA_Pos;
+  MATH->CORDX = ((uint32_t) x) << MATH_CORDX_DATA_Pos;
+}
+
+/* Full circle angle of (x, y) from the vectoring Z result of XMC_MATH_CORDIC_lLoadVectoring(). Adding pi modulo
+ * 2 pi in the 24 bit result is the same as adding +pi for y >= 0 and -pi for y < 0. */
+__STATIC_INLINE XMC_MATH_Q0_23_t XMC_MATH_CORDIC_lAngle(uint32_t corrz, XMC_MATH_Q8_15_t x)
+{
+  uint32_t angle = corrz >> MATH_CORRZ_RESULT_Pos;
+  if (x < 0)
+  {
+    angle = (angle + XMC_MATH_BATCH_PI_IN_Q0_23) & XMC_MATH_BATCH_ANGLE_MASK;
+  }
+  return ((XMC_MATH_Q0_23_t) angle);
+}
+
+/* Removes prescaler and CORDIC gain from a vectoring X result */
+__STATIC_INLINE XMC_MATH_Q8_15_t XMC_MATH_CORDIC_lMagnitude(uint32_t corrx)
+{
+  uint64_t magnitude;
+  magnitude = (uint64_t) (corrx >> MATH_CORRX_RESULT_Pos) * XMC_MATH_RECIPROC_CIRCULAR_GAIN_IN_Q023;
+  return ((XMC_MATH_Q8_15_t) (magnitude >> XMC_MATH_BATCH_MAGNITUDE_SHIFT));
+}
+
+/* Loads element index of a batch, CON is already programmed */
+static void XMC_MATH_CORDIC_lBatchLoad(const XMC_MATH_CORDIC_BATCH_t *const batch, uint32_t index)
+{
+  if (batch->op == XMC_MATH_CORDIC_BATCH_OP_SINCOS)
+  {
+    XMC_MATH_CORDIC_lLoadRotation(batch->in_x[index]);
+  }
+  else
+  {
+    XMC_MATH_CORDIC_lLoadVectoring(batch->in_x[index], batch->in_y[index]);
+  }
+}
 
 /*********************************************************************************************************************
  * API IMPLEMENTATION - Utility functions
@@ -294,6 +356,222 @@ XMC_MATH_Q0_11_t XMC_MATH_CORDIC_Tanh(XMC_MATH_Q0_23_t angle_in_radians)
   return ((XMC_MATH_Q0_11_t) result);
 }
 
+/***********************************************************************************************************************
+ * API IMPLEMENTATION - Batch functions
+ **********************************************************************************************************************/
+/* This function computes sine and cosine of an array of angles in radians */
+void XMC_MATH_CORDIC_SinCosBatch(const XMC_MATH_Q0_23_t *angle, XMC_MATH_Q0_23_t *sin, XMC_MATH_Q0_23_t *cos,
+                                 uint32_t count)
+{
+  uint32_t index;
+  uint32_t corrx;
+  uint32_t corry;
+
+  if (count == 0U)
+  {
+    return;
+  }
+
+  MATH->STATC = 0U; /* Clear register */
+  MATH->CON   = (uint32_t) XMC_MATH_CORDIC_OPERATING_MODE_CIRCULAR + \
+                (uint32_t) XMC_MATH_CORDIC_ROTVEC_MODE_ROTATION;
+  XMC_MATH_CORDIC_lLoadRotation(angle[0]);
+
+  for (index = 0U; index < count; index++)
+  {
+    corrx = MATH->CORRX;  /* Bus waits until the CORDIC is done */
+    corry = MATH->CORRY;
+    if ((index + 1U) < count)
+    {
+      XMC_MATH_CORDIC_lLoadRotation(angle[index + 1U]);  /* Next rotation runs while this result is stored */
+    }
+    if (sin != NULL)
+    {
+      sin[index] = (XMC_MATH_Q0_23_t) (corry >> MATH_CORRY_RESULT_Pos);
+    }
+    if (cos != NULL)
+    {
+      cos[index] = (XMC_MATH_Q0_23_t) (corrx >> MATH_CORRX_RESULT_Pos);
+    }
+  }
+}
+
+/* This function computes arc tangent and magnitude of an array of vectors */
+void XMC_MATH_CORDIC_ArcTanBatch(const XMC_MATH_Q8_15_t *x, const XMC_MATH_Q8_15_t *y, XMC_MATH_Q0_23_t *angle,
+                                 XMC_MATH_Q8_15_t *magnitude, uint32_t count)
+{
+  uint32_t index;
+  uint32_t corrx;
+  uint32_t corrz;
+
+  if (count == 0U)
+  {
+    return;
+  }
+
+  MATH->STATC = 0U; /* Clear register */
+  MATH->CON   = (uint32_t) XMC_MATH_CORDIC_OPERATING_MODE_CIRCULAR + \
+                (uint32_t) XMC_MATH_CORDIC_MAGNITUDE_DIVBY2;
+  XMC_MATH_CORDIC_lLoadVectoring(x[0], y[0]);
+
+  for (index = 0U; index < count; index++)
+  {
+    corrz = MATH->CORRZ;  /* Bus waits until the CORDIC is done */
+    corrx = MATH->CORRX;
+    if ((index + 1U) < count)
+    {
+      XMC_MATH_CORDIC_lLoadVectoring(x[index + 1U], y[index + 1U]);  /* Next vectoring runs meanwhile */
+    }
+    if (angle != NULL)
+    {
+      angle[index] = XMC_MATH_CORDIC_lAngle(corrz, x[index]);
+    }
+    if (magnitude != NULL)
+    {
+      magnitude[index] = XMC_MATH_CORDIC_lMagnitude(corrx);
+    }
+  }
+}
+
+/* This function starts an interrupt driven CORDIC batch */
+void XMC_MATH_CORDIC_StartBatch(XMC_MATH_CORDIC_BATCH_t *const batch)
+{
+  batch->done = 0U;
+  if (batch->count == 0U)
+  {
+    return;
+  }
+
+  xmc_math_cordic_batch = batch;
+  MATH->STATC = 0U; /* Clear register */
+  if (batch->op == XMC_MATH_CORDIC_BATCH_OP_SINCOS)
+  {
+    MATH->CON = (uint32_t) XMC_MATH_CORDIC_OPERATING_MODE_CIRCULAR + \
+                (uint32_t) XMC_MATH_CORDIC_ROTVEC_MODE_ROTATION;
+  }
+  else
+  {
+    MATH->CON = (uint32_t) XMC_MATH_CORDIC_OPERATING_MODE_CIRCULAR + \
+                (uint32_t) XMC_MATH_CORDIC_MAGNITUDE_DIVBY2;
+  }
+  MATH->EVFCR = (uint32_t) XMC_MATH_EVENT_CORDIC_END_OF_CALC;
+  XMC_MATH_EnableEvent(XMC_MATH_EVENT_CORDIC_END_OF_CALC);
+  XMC_MATH_CORDIC_lBatchLoad(batch, 0U);
+}
+
+/* This function serves the CORDIC end of calculation event of a batch */
+void XMC_MATH_CORDIC_BatchHandler(void)
+{
+  XMC_MATH_CORDIC_BATCH_t *const batch = xmc_math_cordic_batch;
+  uint32_t index;
+  uint32_t corrx;
+  uint32_t corra;
+
+  MATH->EVFCR = (uint32_t) XMC_MATH_EVENT_CORDIC_END_OF_CALC;
+  if (batch == NULL)
+  {
+    return;
+  }
+
+  index = batch->done;
+  corrx = MATH->CORRX;
+  corra = (batch->op == XMC_MATH_CORDIC_BATCH_OP_SINCOS) ? MATH->CORRY : MATH->CORRZ;
+  if ((index + 1U) < batch->count)
+  {
+    XMC_MATH_CORDIC_lBatchLoad(batch, index + 1U);
+  }
+  else
+  {
+    XMC_MATH_DisableEvent(XMC_MATH_EVENT_CORDIC_END_OF_CALC);
+    xmc_math_cordic_batch = NULL;
+  }
+
+  if (batch->out_a != NULL)
+  {
+    batch->out_a[index] = (batch->op == XMC_MATH_CORDIC_BATCH_OP_SINCOS) ?
+                          (int32_t) (corra >> MATH_CORRY_RESULT_Pos) :
+                          XMC_MATH_CORDIC_lAngle(corra, batch->in_x[index]);
+  }
+  if (batch->out_b != NULL)
+  {
+    batch->out_b[index] = (batch->op == XMC_MATH_CORDIC_BATCH_OP_SINCOS) ?
+                          (int32_t) (corrx >> MATH_CORRX_RESULT_Pos) : XMC_MATH_CORDIC_lMagnitude(corrx);
+  }
+  batch->done = index + 1U;
+}
+
+/* This function performs unsigned division of two arrays */
+void XMC_MATH_DIV_UnsignedDivBatch(const uint32_t *dividend, const uint32_t *divisor, uint32_t *quotient,
+                                   uint32_t count)
+{
+  uint32_t index;
+  uint32_t result;
+
+  if (count == 0U)
+  {
+    return;
+  }
+
+  MATH->DIVCON = XMC_MATH_UNSIGNED_DIVISION;
+  MATH->DVD    = dividend[0];
+  MATH->DVS    = divisor[0];
+
+  for (index = 1U; index < count; index++)
+  {
+    uint32_t next_dividend = dividend[index];  /* Loaded while the divider works */
+    uint32_t next_divisor  = divisor[index];
+
+    while (MATH->DIVST) /* Wait as divider unit is busy performing requested operation */
+    {
+    }
+    result       = MATH->QUOT;
+    MATH->DVD    = next_dividend;
+    MATH->DVS    = next_divisor;  /* Next division runs while this quotient is stored */
+    quotient[index - 1U] = result;
+  }
+
+  while (MATH->DIVST) /* Wait as divider unit is busy performing requested operation */
+  {
+  }
+  quotient[count - 1U] = MATH->QUOT;
+}
+
+/* This function performs signed division of two arrays */
+void XMC_MATH_DIV_SignedDivBatch(const int32_t *dividend, const int32_t *divisor, int32_t *quotient,
+                                 uint32_t count)
+{
+  uint32_t index;
+  int32_t result;
+
+  if (count == 0U)
+  {
+    return;
+  }
+
+  MATH->DIVCON = XMC_MATH_SIGNED_DIVISION;
+  MATH->DVD    = dividend[0];
+  MATH->DVS    = divisor[0];
+
+  for (index = 1U; index < count; index++)
+  {
+    int32_t next_dividend = dividend[index];  /* Loaded while the divider works */
+    int32_t next_divisor  = divisor[index];
+
+    while (MATH->DIVST) /* Wait as divider unit is busy performing requested operation */
+    {
+    }
+    result       = (int32_t) MATH->QUOT;
+    MATH->DVD    = next_dividend;
+    MATH->DVS    = next_divisor;  /* Next division runs while this quotient is stored */
+    quotient[index - 1U] = result;
+  }
+
+  while (MATH->DIVST) /* Wait as divider unit is busy performing requested operation */
+  {
+  }
+  quotient[count - 1U] = (int32_t) MATH->QUOT;
+}
+
 /***********************************************************************************************************************
  * API IMPLEMENTATION - Non blocking functions
  **********************************************************************************************************************/
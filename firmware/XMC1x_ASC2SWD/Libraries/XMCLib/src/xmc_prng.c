@@ -98,6 +98,73 @@ XMC_PRNG_INIT_STATUS_t XMC_PRNG_Init(const XMC_PRNG_INIT_t *prng)
   return status;
 }
 
+/*
+ * Reads one random word (16 bit) once CHK.RDV is set
+ */
+__STATIC_INLINE uint16_t XMC_PRNG_lReadWord(void)
+{
+  while (0U == XMC_PRNG_CheckValidStatus())
+  {
+  }
+  return PRNG->WORD;
+}
+
+/*
+ * Fills a buffer with random data, two words per 32 bit store
+ */
+void XMC_PRNG_Fill(void *buffer, uint32_t length)
+{
+  uint8_t *dst = (uint8_t *)buffer;
+  uint32_t *dst32;
+  uint32_t words;
+  uint32_t low;
+  uint16_t ctrl;
+  uint16_t rnd;
+
+  XMC_ASSERT("XMC_PRNG_Fill:Null Pointer", ((buffer != NULL) || (length == 0U)));
+
+  ctrl = PRNG->CTRL;
+  XMC_PRNG_SetRandomDataBlockSize(XMC_PRNG_RDBS_WORD);
+
+  /* Leading bytes up to the first word boundary */
+  while ((length > 0U) && (((uint32_t)dst & 3U) != 0U))
+  {
+    *dst = (uint8_t)XMC_PRNG_lReadWord();
+    dst++;
+    length--;
+  }
+
+  /* Aligned part, two PRNG words per store */
+  dst32 = (uint32_t *)(void *)dst;
+  for (words = length >> 2U; words > 0U; words--)
+  {
+    low = XMC_PRNG_lReadWord();
+    *dst32 = low | ((uint32_t)XMC_PRNG_lReadWord() << 16U);
+    dst32++;
+  }
+  dst = (uint8_t *)dst32;
+
+  /* Trailing bytes, at most three */
+  length &= 3U;
+  if (length > 0U)
+  {
+    rnd = XMC_PRNG_lReadWord();
+    while (length > 0U)
+    {
+      *dst = (uint8_t)rnd;
+      rnd >>= 8U;
+      dst++;
+      length--;
+      if (length == 2U)
+      {
+        rnd = XMC_PRNG_lReadWord();
+      }
+    }
+  }
+
+  PRNG->CTRL = ctrl;
+}
+
 /*
  * De-initialize the PRNG peripheral 
  */
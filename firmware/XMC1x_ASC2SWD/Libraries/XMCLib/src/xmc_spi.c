@@ -171,6 +171,118 @@ uint16_t XMC_SPI_CH_GetReceivedData(XMC_USIC_CH_t *const channel)
   return retval;
 }
 
+/* Number of FIFO entries given by the SIZE field of TBCTR or RBCTR. */
+__STATIC_INLINE uint32_t XMC_SPI_CH_lFifoDepth(const uint32_t size)
+{
+  return (size == 0U) ? 0U : ((uint32_t)1U << size);
+}
+
+/* Drains the receive FIFO, then refills the transmit FIFO with no more words in flight than the receive FIFO holds. */
+static void XMC_SPI_CH_lPump(XMC_SPI_CH_TRANSFER_t *const transfer, const uint32_t depth)
+{
+  XMC_USIC_CH_t *const channel = transfer->channel;
+  uint32_t tx_count = transfer->tx_count;
+  uint32_t rx_count = transfer->rx_count;
+  uint16_t data;
+
+  while ((channel->TRBSR & USIC_CH_TRBSR_REMPTY_Msk) == 0U)
+  {
+    data = (uint16_t)channel->OUTR;
+    if (transfer->rx != NULL)
+    {
+      transfer->rx[rx_count] = (uint8_t)data;
+    }
+    rx_count++;
+  }
+
+  while ((tx_count < transfer->length) && ((tx_count - rx_count) < depth) &&
+         ((channel->TRBSR & USIC_CH_TRBSR_TFULL_Msk) == 0U))
+  {
+    channel->IN[0] = (transfer->tx != NULL) ? (uint32_t)transfer->tx[tx_count] : 0xffU;
+    tx_count++;
+  }
+
+  transfer->tx_count = tx_count;
+  transfer->rx_count = rx_count;
+}
+
+/* Transfers a block in standard full duplex mode through the transmit and receive FIFOs. */
+void XMC_SPI_CH_Transfer(XMC_USIC_CH_t *const channel, const uint8_t *tx, uint8_t *rx, const uint32_t length)
+{
+  XMC_SPI_CH_TRANSFER_t transfer;
+  uint32_t depth;
+
+  XMC_ASSERT("XMC_SPI_CH_Transfer: FIFOs not configured",
+             ((channel->TBCTR & USIC_CH_TBCTR_SIZE_Msk) != 0U) && ((channel->RBCTR & USIC_CH_RBCTR_SIZE_Msk) != 0U));
+
+  /* Standard mode, no hardware port control */
+  channel->CCR &= (uint32_t)~USIC_CH_CCR_HPCEN_Msk;
+
+  transfer.channel = channel;
+  transfer.tx = tx;
+  transfer.rx = rx;
+  transfer.length = length;
+  transfer.tx_count = 0U;
+  transfer.rx_count = 0U;
+
+  depth = XMC_SPI_CH_lFifoDepth((channel->RBCTR & USIC_CH_RBCTR_SIZE_Msk) >> USIC_CH_RBCTR_SIZE_Pos);
+  while (transfer.rx_count < length)
+  {
+    XMC_SPI_CH_lPump(&transfer, depth);
+  }
+}
+
+/* Starts a buffered transfer, XMC_SPI_CH_TransferHandler() moves it on. */
+void XMC_SPI_CH_StartTransfer(XMC_SPI_CH_TRANSFER_t *const transfer, XMC_USIC_CH_t *const channel,
+                              const uint8_t *tx, uint8_t *rx, const uint32_t length)
+{
+  XMC_ASSERT("XMC_SPI_CH_StartTransfer: FIFOs not configured",
+             ((channel->TBCTR & USIC_CH_TBCTR_SIZE_Msk) != 0U) && ((channel->RBCTR & USIC_CH_RBCTR_SIZE_Msk) != 0U));
+
+  channel->CCR &= (uint32_t)~USIC_CH_CCR_HPCEN_Msk;
+
+  /* LOF = 1, standard receive buffer event when the filling level exceeds LIMIT, i.e. reaches LIMIT + 1 */
+  channel->RBCTR |= (uint32_t)USIC_CH_RBCTR_LOF_Msk;
+
+  transfer->channel = channel;
+  transfer->tx = tx;
+  transfer->rx = rx;
+  transfer->length = length;
+  transfer->tx_count = 0U;
+  transfer->rx_count = 0U;
+
+  XMC_SPI_CH_TransferHandler(transfer);
+}
+
+/* Moves a buffered transfer on and sets the receive FIFO limit for the next event. */
+void XMC_SPI_CH_TransferHandler(XMC_SPI_CH_TRANSFER_t *const transfer)
+{
+  XMC_USIC_CH_t *const channel = transfer->channel;
+  uint32_t depth;
+  uint32_t in_flight;
+  uint32_t limit;
+
+  depth = XMC_SPI_CH_lFifoDepth((channel->RBCTR & USIC_CH_RBCTR_SIZE_Msk) >> USIC_CH_RBCTR_SIZE_Pos);
+  do
+  {
+    XMC_SPI_CH_lPump(transfer, depth);
+    in_flight = transfer->tx_count - transfer->rx_count;
+    if (in_flight == 0U)
+    {
+      break;
+    }
+
+    /* Refill at half of the words in flight, the last burst completely */
+    limit = (transfer->tx_count < transfer->length) ? (in_flight >> 1U) : in_flight;
+    if (limit == 0U)
+    {
+      limit = 1U;
+    }
+    limit--;
+    channel->RBCTR = (channel->RBCTR & (uint32_t)~USIC_CH_RBCTR_LIMIT_Msk) | (limit << USIC_CH_RBCTR_LIMIT_Pos);
+  } while (XMC_USIC_CH_RXFIFO_GetLevel(channel) > limit);
+}
+
 /* Configures the inter word delay by setting PCR.PCTQ1, PCR.DCTQ1 bit fields. */
 void XMC_SPI_CH_SetInterwordDelay(XMC_USIC_CH_t *const channel,uint32_t tinterword_delay_us)
 {
@@ -92,60 +92,129 @@ void XMC_USIC_CH_Disable(XMC_USIC_CH_t *const channel)
   channel->KSCFG = (uint32_t)((channel->KSCFG & (~USIC_CH_KSCFG_MODEN_Msk)) | USIC_CH_KSCFG_BPMODEN_Msk);
 }
 
-XMC_USIC_CH_STATUS_t XMC_USIC_CH_SetBaudrate(XMC_USIC_CH_t *const channel, uint32_t rate, uint32_t oversampling)
+XMC_USIC_CH_STATUS_t XMC_USIC_CH_GetBaudrateDivider(uint32_t peripheral_clock, uint32_t rate, uint32_t oversampling,
+                                                    XMC_USIC_CH_BAUDRATE_DIVIDER_t *const divider)
 {
   XMC_USIC_CH_STATUS_t status;
-  
-  uint32_t peripheral_clock;
-  
-  uint32_t clock_divider;
-  uint32_t clock_divider_min;
 
-  uint32_t pdiv;
+  uint32_t clock;
+  uint32_t quanta;
+  uint32_t period;
+
+  uint32_t step;
+  uint32_t step_inc;
+  uint32_t step_min;
+
   uint32_t pdiv_int;
   uint32_t pdiv_int_min;
-  
-  uint32_t pdiv_frac;
-  uint32_t pdiv_frac_min;
+
+  uint32_t wrap;
+  uint32_t frac;
+  uint32_t frac_rem;
+  uint32_t frac_min;
+  uint32_t wrap_frac;
+  uint32_t wrap_rem;
+  uint32_t clock_frac;
+  uint32_t clock_rem;
+  uint32_t borrow;
 
   /* The rate and peripheral clock are divided by 100 to be able to use only 32bit arithmetic */
-  if ((rate >= 100U) && (oversampling != 0U))
+  clock = peripheral_clock / 100U;
+  quanta = (rate / 100U) * oversampling;
+
+  /* pdiv_int = 1 needs a STEP below 1024, checked again by the loop */
+  status = XMC_USIC_CH_STATUS_ERROR;
+  if ((rate >= 100U) && (oversampling != 0U) && (quanta < clock))
   {
-    peripheral_clock = XMC_SCU_CLOCK_GetPeripheralClockFrequency() / 100U;
-    rate = rate / 100U;
+    /*
+     * STEP * clock = pdiv_int * period + e, 0 <= e < clock, the PDIV fraction is e / quanta.
+     * Within one pdiv_int the fraction grows with STEP, so only the smallest STEP of each pdiv_int,
+     * ceil(pdiv_int * period / clock), is a candidate. From one pdiv_int to the next, STEP grows by
+     * step_inc and e drops by wrap; when e would become negative it wraps by clock and STEP grows by
+     * one more. e is kept as quotient and remainder by quanta, so the loop needs no division.
+     */
+    period = quanta << 10U;
+    step_inc = period / clock;
+    wrap = period - (step_inc * clock);
+
+    wrap_frac = wrap / quanta;
+    wrap_rem = wrap - (wrap_frac * quanta);
+    clock_frac = clock / quanta;
+    clock_rem = clock - (clock_frac * quanta);
+
+    /* pdiv_int = 1: e = (clock - wrap) % clock */
+    step = step_inc;
+    frac = 0U;
+    frac_rem = 0U;
+    if (wrap != 0U)
+    {
+      step++;
+      frac = (clock - wrap) / quanta;
+      frac_rem = (clock - wrap) - (frac * quanta);
+    }
 
-    clock_divider_min = 1U;
+    step_min = 1U;
     pdiv_int_min = 1U;
-    pdiv_frac_min = 0x3ffU;
+    frac_min = 0x3ffU;
 
-    for(clock_divider = 1023U; clock_divider > 0U; --clock_divider)
+    for (pdiv_int = 1U; (pdiv_int < 1024U) && (step < 1024U); ++pdiv_int)
     {
-      pdiv = ((peripheral_clock * clock_divider) / (rate * oversampling));
-      pdiv_int = pdiv >> 10U;
-      pdiv_frac = pdiv & 0x3ffU;
-
-      if ((pdiv_int < 1024U) && (pdiv_frac < pdiv_frac_min))
+      /* Ties go to the larger STEP */
+      if ((frac <= frac_min) && (frac < 0x3ffU))
       {
-        pdiv_frac_min = pdiv_frac;
+        frac_min = frac;
         pdiv_int_min = pdiv_int;
-        clock_divider_min = clock_divider;
+        step_min = step;
+      }
+
+      /* e -= wrap */
+      borrow = (frac_rem < wrap_rem) ? 1U : 0U;
+      frac_rem = (frac_rem + (borrow * quanta)) - wrap_rem;
+      borrow += wrap_frac;
+      step += step_inc;
+
+      if (frac < borrow)
+      {
+        /* e += clock */
+        frac = (frac + clock_frac) - borrow;
+        frac_rem += clock_rem;
+        if (frac_rem >= quanta)
+        {
+          frac_rem -= quanta;
+          frac++;
+        }
+        step++;
+      }
+      else
+      {
+        frac -= borrow;
       }
     }
 
-    channel->FDR = XMC_USIC_CH_BRG_CLOCK_DIVIDER_MODE_FRACTIONAL |
-                   (clock_divider_min << USIC_CH_FDR_STEP_Pos);
+    /* No candidate if already the first STEP is 1024 */
+    if (frac_min < 0x3ffU)
+    {
+      divider->step = (uint16_t)step_min;
+      divider->pdiv = (uint16_t)(pdiv_int_min - 1U);
 
-    channel->BRG = (channel->BRG & ~(USIC_CH_BRG_DCTQ_Msk | USIC_CH_BRG_PDIV_Msk)) | 
-                   ((oversampling - 1U) << USIC_CH_BRG_DCTQ_Pos) |
-                   ((pdiv_int_min - 1U) << USIC_CH_BRG_PDIV_Pos);
-                    
-    status = XMC_USIC_CH_STATUS_OK;
+      status = XMC_USIC_CH_STATUS_OK;
+    }
   }
-  else 
+
+  return status;
+}
+
+XMC_USIC_CH_STATUS_t XMC_USIC_CH_SetBaudrate(XMC_USIC_CH_t *const channel, uint32_t rate, uint32_t oversampling)
+{
+  XMC_USIC_CH_STATUS_t status;
+  XMC_USIC_CH_BAUDRATE_DIVIDER_t divider;
+
+  status = XMC_USIC_CH_GetBaudrateDivider(XMC_SCU_CLOCK_GetPeripheralClockFrequency(), rate, oversampling, &divider);
+  if (status == XMC_USIC_CH_STATUS_OK)
   {
-    status = XMC_USIC_CH_STATUS_ERROR;
+    XMC_USIC_CH_SetBaudrateDivider(channel, &divider, oversampling);
   }
-  
+
   return status;
 }
 
@@ -1681,4 +1681,98 @@ bool XMC_VADC_GROUP_IsResultRegisterFifoHead(XMC_VADC_GROUP_t *const group_ptr,
   return ret_val;
 }
 
+/* API to stream a result FIFO into a ring buffer */
+XMC_VADC_STATUS_t XMC_VADC_GROUP_StreamInit(XMC_VADC_STREAM_t *const stream,
+                                            XMC_VADC_GROUP_t *const group_ptr,
+                                            const uint32_t head,
+                                            const uint32_t depth,
+                                            uint32_t *const buffer,
+                                            const uint32_t size,
+                                            const XMC_VADC_SR_t sr)
+{
+  uint32_t res_reg;
+
+  XMC_ASSERT("XMC_VADC_GROUP_StreamInit:Wrong Group Pointer", XMC_VADC_CHECK_GROUP_PTR(group_ptr))
+  XMC_ASSERT("XMC_VADC_GROUP_StreamInit:Wrong Service Request", ((sr)  < XMC_VADC_SR_MAX))
+
+  if ((head >= XMC_VADC_NUM_RESULT_REGISTERS) || (depth < 2U) || (depth > (head + 1U)) ||
+      (size == 0U) || ((size & (size - 1U)) != 0U))
+  {
+    return XMC_VADC_STATUS_ERROR;
+  }
+
+  stream->group_ptr = group_ptr;
+  stream->tail      = head + 1U - depth;
+  stream->buffer    = buffer;
+  stream->mask      = size - 1U;
+  stream->write     = 0U;
+  stream->read      = 0U;
+  stream->overruns  = 0U;
+
+  /* The head receives the conversions, all lower members pass them down to the tail */
+  group_ptr->RCR[head] &= ~((uint32_t)VADC_G_RCR_FEN_Msk);
+  for (res_reg = stream->tail; res_reg < head; res_reg++)
+  {
+    XMC_VADC_GROUP_AddResultToFifo(group_ptr, res_reg);
+  }
+
+  XMC_VADC_GROUP_SetResultInterruptNode(group_ptr, stream->tail, sr);
+  XMC_VADC_GROUP_EnableResultEvent(group_ptr, stream->tail);
+
+  return XMC_VADC_STATUS_SUCCESS;
+}
+
+/* API to drain a streamed result FIFO, called from the result event handler */
+void XMC_VADC_GROUP_StreamHandler(XMC_VADC_STREAM_t *const stream)
+{
+  XMC_VADC_GROUP_t *const group_ptr = stream->group_ptr;
+  uint32_t write = stream->write;
+  uint32_t free_space = (stream->mask + 1U) - (write - stream->read);
+  uint32_t res;
+
+  /* Each read of the tail clears its valid flag and moves the next result down */
+  res = group_ptr->RES[stream->tail];
+  while (res & (uint32_t)VADC_G_RES_VF_Msk)
+  {
+    if (free_space > 0U)
+    {
+      stream->buffer[write & stream->mask] = res;
+      write++;
+      free_space--;
+    }
+    else
+    {
+      stream->overruns++;
+    }
+    res = group_ptr->RES[stream->tail];
+  }
+
+  __DMB(); /* Results are in the ring before the consumer sees them */
+  stream->write = write;
+}
+
+/* API to read results out of a stream */
+uint32_t XMC_VADC_GROUP_StreamRead(XMC_VADC_STREAM_t *const stream, uint32_t *const results, const uint32_t max)
+{
+  uint32_t read = stream->read;
+  uint32_t count = stream->write - read;
+  uint32_t i;
+
+  if (count > max)
+  {
+    count = max;
+  }
+  __DMB(); /* Ring is read after the write count */
+
+  for (i = 0U; i < count; i++)
+  {
+    results[i] = stream->buffer[read & stream->mask];
+    read++;
+  }
+
+  __DMB(); /* Ring is read before the space is handed back */
+  stream->read = read;
+  return count;
+}
+
 #endif /*XMC_VADC_GROUP_AVAILABLE */
@@ -0,0 +1,160 @@
+/**************************************************************************
+ * @file     stage1.c
+ * @brief    First stage of the XMC1000 Bootloader chain
+ *
+ *           Uploaded by the ROM ASC BSL instead of the full loader. It
+ *           switches the ASC_CHANNEL USIC channel (asc_transport.h) to the
+ *           baud rate requested by the host, receives the (compressed) main loader above itself,
+ *           checks it and jumps to it. No .data/.bss, no library calls.
+ *
+ *           Host -> stage 1, at the ROM BSL baud:
+ *             FDR STEP (2 bytes), BRG PDIV (2 bytes)       LSB first
+ *           stage 1 -> host: BSL_SUCCESS, then the baud rate changes.
+ *           Host -> stage 1, at the new baud:
+ *             compressed size, size, byte sum (4 bytes each)  LSB first
+ *             compressed size bytes (0: size bytes, uncompressed)
+ *           stage 1 -> host: BSL_SUCCESS and jump, or an error code and
+ *           wait for the next size header.
+ *
+ *           Compressed stream, one token byte each:
+ *             0x00..0x7F  (t+1) literal bytes follow
+ *             0x80..0xFF  copy (t-0x80+3) bytes from 2 byte distance back
+ *
+ **************************************************************************/
+
+#include <XMC1300.h>
+#include "asc_transport.h"
+
+#if ASC_CHANNEL == ASC_CHANNEL_AUTO
+#error "stage 1 has no .data/.bss, select ASC_CHANNEL 0 or 1"
+#endif
+
+// ----------------------------------------------------------------------------
+//   local defines
+// ----------------------------------------------------------------------------
+
+#define STAGE2_BASE      0x20000600   // ORIGIN of the stage 2 SRAM_1 region
+#define SRAM_END         0x20004000
+
+#define ASC_DCTQ         15           // 16 time quanta per bit
+#define ASC_SP           9            // sample point in the middle of the bit
+
+// ----------------------------------------------------------------------------
+//   local functions
+// ----------------------------------------------------------------------------
+
+#define RxByte           ASC_GetByte
+#define TxByte           ASC_PutByte
+
+static DWORD RxDword(void)
+{
+	DWORD dw = RxByte();
+	dw |= (DWORD)RxByte() << 8;
+	dw |= (DWORD)RxByte() << 16;
+	dw |= (DWORD)RxByte() << 24;
+	return dw;
+}
+
+static void SetBaud(DWORD step, DWORD pdiv)
+{
+	// let the acknowledge leave at the old baud rate
+	ASC_Flush();
+
+	ASC_CH->FDR = (2UL << USIC_CH_FDR_DM_Pos) | (step & USIC_CH_FDR_STEP_Msk);
+	ASC_CH->BRG = (ASC_CH->BRG & ~(USIC_CH_BRG_PDIV_Msk | USIC_CH_BRG_DCTQ_Msk | USIC_CH_BRG_PCTQ_Msk)) |
+	              ((pdiv << USIC_CH_BRG_PDIV_Pos) & USIC_CH_BRG_PDIV_Msk) |
+	              (ASC_DCTQ << USIC_CH_BRG_DCTQ_Pos);
+	ASC_CH->PCR_ASCMode = (ASC_CH->PCR_ASCMode & ~USIC_CH_PCR_ASCMode_SP_Msk) |
+	                      USIC_CH_PCR_ASCMode_SMD_Msk | (ASC_SP << USIC_CH_PCR_ASCMode_SP_Pos);
+}
+
+static BYTE* Inflate(const BYTE* src, const BYTE* end, BYTE* dst)
+{
+	UINT n;
+	BYTE t;
+
+	while (src < end)
+	{
+		t = *src++;
+		if (t < 0x80)
+		{
+			for (n = t + 1; n; n--)
+				*dst++ = *src++;
+		}
+		else
+		{
+			const BYTE* from = dst - (src[0] | (src[1] << 8));
+			src += 2;
+			for (n = t - 0x80 + 3; n; n--)
+				*dst++ = *from++;
+		}
+	}
+	return dst;
+}
+
+void Stage1_Main(void)
+{
+	DWORD packed, size, sum, i;
+	BYTE* buf;
+
+	// FDR STEP and BRG PDIV for the new baud rate, computed by the host
+	packed = RxByte();
+	packed |= (DWORD)RxByte() << 8;
+	size = RxByte();
+	size |= (DWORD)RxByte() << 8;
+	TxByte(BSL_SUCCESS);
+	SetBaud(packed, size);
+
+	for (;;)
+	{
+		packed = RxDword();
+		size = RxDword();
+		sum = RxDword();
+
+		// compressed data goes to the (word aligned) top of SRAM and is
+		// inflated upwards, the output must not reach it
+		if (size + packed + 3 > SRAM_END - STAGE2_BASE)
+		{
+			TxByte(BSL_ADDRESS_ERROR);
+			continue;
+		}
+		buf = packed ? (BYTE*)((SRAM_END - packed) & ~3UL) : (BYTE*)STAGE2_BASE;
+		for (i = 0; i < (packed ? packed : size); i++)
+			buf[i] = RxByte();
+		if (packed && (Inflate(buf, buf + packed, (BYTE*)STAGE2_BASE) != (BYTE*)STAGE2_BASE + size))
+		{
+			TxByte(BSL_CHKSUM_ERROR);
+			continue;
+		}
+
+		buf = (BYTE*)STAGE2_BASE;
+		for (i = 0; i < size; i++)
+			sum -= buf[i];
+		if (sum != 0)
+		{
+			TxByte(BSL_CHKSUM_ERROR);
+			continue;
+		}
+
+		// the stage 2 reset handler is the first word of its image
+		TxByte(BSL_SUCCESS);
+		((void (*)(void))(STAGE2_BASE | 1))();
+	}
+}
+
+// ----------------------------------------------------------------------------
+//   reset entry, placed at 0x20000200 where the ROM BSL starts the image
+// ----------------------------------------------------------------------------
+
+extern unsigned int __stage1_stack;
+void Stage1_Main(void);
+
+__attribute__((naked, section(".stage1.reset"))) void Stage1_Reset(void)
+{
+	__asm volatile (
+		"ldr  r0, =__stage1_stack \n"
+		"mov  sp, r0              \n"
+		"bl   Stage1_Main         \n"
+		".pool                    \n"
+	);
+}
@@ -0,0 +1,167 @@
+/**************************************************************************
+ * @file     bench_gpio_edge.c
+ * @brief    XMC_GPIO_ModifyOutput() clock edges against per-pin calls
+ *
+ *           The port argument of every XMC_GPIO call is SimPort(), which
+ *           counts the call, applies the Pn_OMR store of the previous one
+ *           and sets Pn_IN to the levels before the store of this one,
+ *           like the input synchronizer does. A shift register device on
+ *           the port takes MOSI on rising SCK edges and drives MISO after
+ *           falling ones. Bytes are exchanged full duplex, LSB first, with
+ *           the multi-pin calls and with the single pin calls bit-banged
+ *           code used before. Checked are the data in both directions and
+ *           that MOSI never changes with a rising SCK edge. Reported are
+ *           Pn_OMR stores and GPIO calls per clock edge.
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <XMC1300.h>
+#include "xmc_gpio.h"
+
+#define SCK_PIN        0
+#define MOSI_PIN       1
+#define MISO_PIN       2
+#define SCK            (1U << SCK_PIN)
+#define MOSI           (1U << MOSI_PIN)
+#define MISO           (1U << MISO_PIN)
+
+#define BYTES          4096
+
+static XMC_GPIO_PORT_t SimRegs;
+static uint32_t PinOut = SCK;     // SCK idles high
+static uint32_t SimCalls;
+static uint32_t SimStores;
+static uint32_t SimRaceStores;    // MOSI changed in a store raising SCK
+
+// shift register device
+static uint8_t DevIn[BYTES], DevOut[BYTES];
+static uint32_t DevBit;           // bits taken so far
+static uint32_t DevMiso;
+
+static void DevEdge(uint32_t before)
+{
+	if (!(before & SCK) && (PinOut & SCK))
+	{
+		if (PinOut & MOSI)
+			DevIn[DevBit >> 3] |= (uint8_t)(1U << (DevBit & 7U));
+		DevBit++;
+	}
+	else if ((before & SCK) && !(PinOut & SCK) && (DevBit < 8U * BYTES))
+	{
+		DevMiso = (DevOut[DevBit >> 3] >> (DevBit & 7U)) & 1U;
+	}
+}
+
+static XMC_GPIO_PORT_t* SimPort(void)
+{
+	uint32_t omr = SimRegs.OMR;
+	uint32_t before = PinOut;
+
+	if (omr)
+	{
+		PinOut = (PinOut | (omr & 0xFFFFU)) & ~((omr >> 16) & ~omr);
+		PinOut ^= omr & (omr >> 16) & 0xFFFFU;
+		SimRegs.OMR = 0;
+		SimStores++;
+		if (!(before & SCK) && (PinOut & SCK) && ((before ^ PinOut) & MOSI))
+			SimRaceStores++;
+		DevEdge(before);
+	}
+	*(volatile uint32_t*)&SimRegs.IN = PinOut | (DevMiso ? MISO : 0U);
+	SimCalls++;
+	return &SimRegs;
+}
+
+// Falling edge with the data bit in one Pn_OMR store, rising edge and
+// sample in one inline sequence
+static uint32_t ExchangeModify(uint32_t out)
+{
+	uint32_t in = 0;
+	uint32_t i;
+
+	for (i=0; i<8U; i++)
+	{
+		if (out & (1U << i))
+			XMC_GPIO_ModifyOutput(SimPort(), MOSI, SCK);
+		else
+			XMC_GPIO_ModifyOutput(SimPort(), 0, SCK | MOSI);
+		if (XMC_GPIO_ModifyOutputGetInput(SimPort(), SCK, 0) & MISO)
+			in |= 1U << i;
+	}
+	return in;
+}
+
+// Clock and data pin one call each, as before XMC_GPIO_ModifyOutput()
+static uint32_t ExchangePerPin(uint32_t out)
+{
+	uint32_t in = 0;
+	uint32_t i;
+
+	for (i=0; i<8U; i++)
+	{
+		XMC_GPIO_SetOutputLow(SimPort(), SCK_PIN);
+		XMC_GPIO_SetOutputLevel(SimPort(), MOSI_PIN,
+		                        (out & (1U << i)) ? XMC_GPIO_OUTPUT_LEVEL_HIGH : XMC_GPIO_OUTPUT_LEVEL_LOW);
+		XMC_GPIO_SetOutputHigh(SimPort(), SCK_PIN);
+		if (XMC_GPIO_GetInput(SimPort(), MISO_PIN))
+			in |= 1U << i;
+	}
+	return in;
+}
+
+static int Bench(const char* name, uint32_t (*exchange)(uint32_t))
+{
+	uint8_t host_in[BYTES];
+	uint32_t state = 0x9E3779B9U;
+	uint32_t i;
+	int failed = 0;
+
+	for (i=0; i<BYTES; i++)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		DevOut[i] = (uint8_t)state;
+		DevIn[i] = 0;
+	}
+	DevBit = 0;
+	DevMiso = 0;
+	SimCalls = 0;
+	SimStores = 0;
+	SimRaceStores = 0;
+
+	for (i=0; i<BYTES; i++)
+		host_in[i] = (uint8_t)exchange(DevOut[(i + 1U) % BYTES] ^ 0xA5U);
+	(void)SimPort();    // last store
+
+	for (i=0; i<BYTES; i++)
+	{
+		if ((DevIn[i] != (uint8_t)(DevOut[(i + 1U) % BYTES] ^ 0xA5U)) || (host_in[i] != DevOut[i]))
+		{
+			if (failed++ < 5)
+				printf("FAIL %s byte %u: device got 0x%02x, host got 0x%02x\n", name, (unsigned)i,
+				       DevIn[i], host_in[i]);
+		}
+	}
+	if (SimRaceStores != 0U)
+	{
+		printf("FAIL %s: MOSI changed with %u rising SCK edges\n", name, (unsigned)SimRaceStores);
+		failed++;
+	}
+
+	printf("  %-12s %4.2f Pn_OMR stores and %4.2f GPIO calls per clock edge\n", name,
+	       (double)SimStores / (16.0 * BYTES), (double)(SimCalls - 1U) / (16.0 * BYTES));
+	return failed;
+}
+
+int main(void)
+{
+	int failed = 0;
+
+	printf("bench_gpio_edge: %u bytes full duplex, LSB first:\n", (unsigned)BYTES);
+	failed += Bench("ModifyOutput", ExchangeModify);
+	failed += Bench("per pin", ExchangePerPin);
+	printf("bench_gpio_edge: %d failed\n", failed);
+	return failed != 0;
+}
@@ -0,0 +1,154 @@
+/**************************************************************************
+ * @file     bench_prng_fill.c
+ * @brief    XMC_PRNG_Fill() against a simulated PRNG register block
+ *
+ *           Every PRNG-> access of xmc_prng.c goes through SimAccess(),
+ *           which counts it and loads the next word of an xorshift
+ *           generator into WORD. Checked are the bytes written at every
+ *           alignment and length (and nothing around them), the restored
+ *           CTRL and the byte distribution of a large fill. Reported are
+ *           register accesses per byte, the cost on the target, against
+ *           the per-byte reads callers did before, and host throughput.
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <XMC1300.h>
+
+static PRNG_Type SimPrng = { .CHK = 0x01 };    // RDV always set
+static uint32_t SimState;
+static uint32_t SimAccesses;
+
+static PRNG_Type* SimAccess(void)
+{
+	SimState ^= SimState << 13;
+	SimState ^= SimState >> 17;
+	SimState ^= SimState << 5;
+	SimPrng.WORD = (uint16_t)(SimState >> 8);
+	SimAccesses++;
+	return &SimPrng;
+}
+
+#undef PRNG
+#define PRNG (SimAccess())
+#pragma GCC diagnostic ignored "-Wtautological-compare"    // xmc_prng.h RDBS check
+#include "../Libraries/XMCLib/src/xmc_prng.c"
+#pragma GCC diagnostic warning "-Wtautological-compare"
+
+#define GUARD          16
+#define CHECK_SIZE     64
+#define STAT_SIZE      (1UL << 20)
+#define BENCH_SIZE     (1UL << 24)
+
+static uint8_t Buf[2][GUARD + STAT_SIZE + GUARD];
+
+// Per-byte reads with a ready check each, as callers did without Fill.
+// WORD is read directly: XMC_PRNG_GetPseudoRandomNumber() compares the
+// unshifted RDBS value against the field and never masks
+static void FillBytes(uint8_t* dst, uint32_t length)
+{
+	XMC_PRNG_SetRandomDataBlockSize(XMC_PRNG_RDBS_BYTE);
+	while (length--)
+	{
+		while (XMC_PRNG_CheckValidStatus() == 0U) {}
+		*dst++ = (uint8_t)PRNG->WORD;
+	}
+}
+
+// Same seed into buffers cleared to 0x00 and 0xFF: the range must come out
+// equal in both, the guard bytes unchanged
+static int CheckRange(uint32_t offset, uint32_t length)
+{
+	uint32_t i;
+	int b;
+
+	for (b=0; b<2; b++)
+	{
+		memset(Buf[b], b ? 0xFF : 0x00, GUARD + CHECK_SIZE + GUARD);
+		SimState = 0x12345678U + offset * 97U + length;
+		SimPrng.CTRL = 0x5A00U | ((uint16_t)XMC_PRNG_RDBS_BYTE << PRNG_CTRL_RDBS_Pos);
+		XMC_PRNG_Fill(&Buf[b][GUARD + offset], length);
+		if (SimPrng.CTRL != (0x5A00U | ((uint16_t)XMC_PRNG_RDBS_BYTE << PRNG_CTRL_RDBS_Pos)))
+		{
+			printf("FAIL offset %u length %u: CTRL not restored\n", (unsigned)offset, (unsigned)length);
+			return 1;
+		}
+	}
+	for (i=0; i<GUARD + CHECK_SIZE + GUARD; i++)
+	{
+		int inside = (i >= GUARD + offset) && (i < GUARD + offset + length);
+		if (inside ? (Buf[0][i] != Buf[1][i]) : ((Buf[0][i] != 0x00) || (Buf[1][i] != 0xFF)))
+		{
+			printf("FAIL offset %u length %u: byte %d %s\n", (unsigned)offset, (unsigned)length,
+			       (int)i - GUARD - (int)offset, inside ? "not written" : "written");
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Chi-square of the byte histogram, 255 degrees of freedom: mean 255,
+// standard deviation ~22.6
+static double ChiSquare(const uint8_t* data, uint32_t length)
+{
+	uint32_t count[256] = {0};
+	double expected = length / 256.0;
+	double chi = 0.0;
+	uint32_t i;
+
+	for (i=0; i<length; i++)
+		count[data[i]]++;
+	for (i=0; i<256; i++)
+		chi += (count[i] - expected) * (count[i] - expected) / expected;
+	return chi;
+}
+
+static void Bench(const char* name, void (*fill)(void*, uint32_t))
+{
+	uint32_t done;
+	clock_t start;
+	double seconds;
+
+	SimAccesses = 0;
+	start = clock();
+	for (done=0; done<BENCH_SIZE; done+=STAT_SIZE)
+		fill(&Buf[0][GUARD + 1], STAT_SIZE - 1);
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	printf("  %-10s %5.2f register accesses per byte, %7.1f MB/s on the host\n", name,
+	       (double)SimAccesses / (BENCH_SIZE - BENCH_SIZE / STAT_SIZE),
+	       (BENCH_SIZE - BENCH_SIZE / STAT_SIZE) / seconds / 1e6);
+}
+
+static void FillBytesBench(void* dst, uint32_t length)
+{
+	FillBytes(dst, length);
+}
+
+int main(void)
+{
+	uint32_t offset, length;
+	double chi;
+	int failed = 0;
+
+	for (offset=0; offset<8; offset++)
+		for (length=0; length<=CHECK_SIZE - offset; length++)
+			failed += CheckRange(offset, length);
+
+	SimState = 1;
+	XMC_PRNG_Fill(&Buf[0][GUARD + 3], STAT_SIZE - 3);
+	chi = ChiSquare(&Buf[0][GUARD + 3], STAT_SIZE - 3);
+	if ((chi < 150.0) || (chi > 400.0))
+	{
+		printf("FAIL byte distribution: chi-square %.1f, expected 255 +- 23\n", chi);
+		failed++;
+	}
+
+	printf("bench_prng_fill: chi-square %.1f (255 +- 23), unaligned fills of %lu bytes:\n", chi,
+	       (unsigned long)STAT_SIZE - 1);
+	Bench("Fill", XMC_PRNG_Fill);
+	Bench("per byte", FillBytesBench);
+	printf("bench_prng_fill: %d failed\n", failed);
+	return failed != 0;
+}
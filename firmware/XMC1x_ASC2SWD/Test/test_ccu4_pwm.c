@@ -0,0 +1,126 @@
+/**************************************************************************
+ * @file     test_ccu4_pwm.c
+ * @brief    XMC_CCU4_GetPwmMeasurements() against a simulated PWM input
+ *
+ *           A random PWM input is turned into the captures of a slice
+ *           that clears its timer on the period start edge: the period
+ *           start set gets the ticks since the last period start, the
+ *           pulse end set the ticks since the period start. The captures
+ *           reach the timestamp buffers in drains at random points, also
+ *           between the period start and the pulse end of a period and
+ *           between the two sets of one drain, and measurements are taken
+ *           at random in between. Every period must come out once, in
+ *           order and with its own pulse width.
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <XMC1300.h>
+
+#include "../Libraries/XMCLib/src/xmc_ccu4.c"
+
+#define PERIODS                20000
+#define BUFFER_SIZE            16
+
+static uint32_t State = 0x2545F491U;
+
+static uint32_t Random(uint32_t range)
+{
+	State ^= State << 13;
+	State ^= State >> 17;
+	State ^= State << 5;
+	return State % range;
+}
+
+static uint16_t Period[PERIODS];
+static uint16_t Pulse[PERIODS];
+
+// Input edges, even ones start a period, odd ones end its pulse
+static uint32_t Edge;
+static uint32_t PeriodEdges, PulseEdges;
+
+static uint32_t PeriodValues[BUFFER_SIZE];
+static uint32_t PulseValues[BUFFER_SIZE];
+static XMC_CCU4_CAPTURE_BUFFER_t Buffers[2] =
+{
+	{ .values = PeriodValues, .size = BUFFER_SIZE },
+	{ .values = PulseValues, .size = BUFFER_SIZE },
+};
+
+// Captured value of an edge, with a floating prescaler value the API has to mask
+static uint32_t Capture(uint32_t edge)
+{
+	uint32_t k = edge >> 1;
+
+	if (edge & 1U)
+		return Pulse[k] | (Random(16) << CCU4_CC4_CV_FPCV_Pos);
+	// the first period start captures the ticks since the timer start
+	return ((k == 0U) ? 0x1234U : Period[k - 1U]) | (Random(16) << CCU4_CC4_CV_FPCV_Pos);
+}
+
+static void Store(XMC_CCU4_CAPTURE_BUFFER_t *buffer, uint32_t edge)
+{
+	XMC_CCU4_lStoreCapture(buffer, Capture(edge));
+}
+
+// Drains period and pulse set, one after the other like XMC_CCU4_DrainCaptures()
+static void Drain(uint32_t edges)
+{
+	uint32_t limit;
+
+	Edge += edges;
+	if (Edge > 2U * PERIODS)
+		Edge = 2U * PERIODS;
+	for (; PeriodEdges < Edge; PeriodEdges += 2U)
+		Store(&Buffers[0], PeriodEdges);
+
+	// an edge may arrive between reading the two sets
+	limit = (Edge < 2U * PERIODS) ? Edge + Random(2) : Edge;
+	Edge = limit;
+	for (; PulseEdges < Edge; PulseEdges += 2U)
+		Store(&Buffers[1], PulseEdges);
+}
+
+int main(void)
+{
+	XMC_CCU4_PWM_MEASUREMENT_t results[4];
+	uint32_t measured = 0;
+	uint32_t count, i;
+	int failed = 0;
+
+	for (i=0; i<PERIODS; i++)
+	{
+		Period[i] = (uint16_t)(2U + Random(65534U));
+		Pulse[i] = (uint16_t)(1U + Random(Period[i] - 1U));
+	}
+	PulseEdges = 1;
+
+	while (measured < PERIODS - 1U)
+	{
+		if (Random(2))
+			Drain(Random(7));
+
+		count = XMC_CCU4_GetPwmMeasurements(&Buffers[0], &Buffers[1], results, 1U + Random(4));
+		for (i=0; i<count; i++, measured++)
+		{
+			if ((measured >= PERIODS) || (results[i].period != Period[measured]) ||
+			    (results[i].pulse != Pulse[measured]))
+			{
+				if (failed++ < 10)
+					printf("FAIL period %u: %u/%u expected %u/%u\n", (unsigned)measured,
+					       (unsigned)results[i].pulse, (unsigned)results[i].period,
+					       (unsigned)Pulse[measured], (unsigned)Period[measured]);
+			}
+		}
+		if (failed > 100)
+			break;
+	}
+	if ((Buffers[0].lost != 0U) || (Buffers[1].lost != 0U))
+	{
+		printf("FAIL lost %u %u\n", (unsigned)Buffers[0].lost, (unsigned)Buffers[1].lost);
+		failed++;
+	}
+
+	printf("test_ccu4_pwm: %d of %u periods failed\n", failed, (unsigned)measured);
+	return failed != 0;
+}
@@ -0,0 +1,152 @@
+/**************************************************************************
+ * @file     test_math_cordic.c
+ * @brief    XMC_MATH_CORDIC_ArcTanBatch() against a simulated CORDIC
+ *
+ *           Every MATH-> access of xmc_math.c goes through SimMath(),
+ *           which runs the CORDIC once CORDX was written, as the hardware
+ *           starts on that write. The model iterates shift and add like
+ *           the hardware, so circular vectoring of a vector with x < 0
+ *           does not converge there either. The batch results of vectors
+ *           all around the circle are compared with atan2() and the
+ *           magnitude, for the blocking and the interrupt driven batch.
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include <XMC1300.h>
+
+static MATH_Type SimRegs;
+
+#define CORDX_IDLE             0x5AU   // never written, data sits in bits 31..8
+#define FRACTION               16      // extra bits of the model datapath
+#define ITERATIONS             32
+
+static int32_t Ext24(uint32_t value)
+{
+	return (int32_t)(value << 8) >> 8;
+}
+
+static void Cordic(void)
+{
+	uint32_t con = SimRegs.CON;
+	int64_t x = (int64_t)Ext24(SimRegs.CORDX >> 8) << FRACTION;
+	int64_t y = (int64_t)Ext24(SimRegs.CORDY >> 8) << FRACTION;
+	int64_t z = (int64_t)Ext24(SimRegs.CORDZ >> 8) << FRACTION;
+	int64_t xi, a;
+	int i;
+
+	for (i=0; i<ITERATIONS; i++)
+	{
+		// atan(2^-i) as a normalised angle, pi = 2^23
+		a = llround(atan(ldexp(1.0, -i)) / M_PI * ldexp(1.0, 23 + FRACTION));
+		xi = x;
+		// clockwise while vectoring drives y, rotation drives z towards 0
+		if ((con & MATH_CON_ROTVEC_Msk) ? (z < 0) : (y >= 0))
+		{
+			x += y >> i;
+			y -= xi >> i;
+			z += a;
+		}
+		else
+		{
+			x -= y >> i;
+			y += xi >> i;
+			z -= a;
+		}
+	}
+	x >>= (con & MATH_CON_MPS_Msk) >> MATH_CON_MPS_Pos;
+	*(volatile uint32_t*)&SimRegs.CORRX = ((uint32_t)(x >> FRACTION) & 0xFFFFFFU) << 8;
+	*(volatile uint32_t*)&SimRegs.CORRY = ((uint32_t)(y >> FRACTION) & 0xFFFFFFU) << 8;
+	*(volatile uint32_t*)&SimRegs.CORRZ = ((uint32_t)(z >> FRACTION) & 0xFFFFFFU) << 8;
+}
+
+// Runs the CORDIC started by the CORDX store of an earlier access
+static MATH_Type* SimMath(void)
+{
+	if (SimRegs.CORDX != CORDX_IDLE)
+	{
+		Cordic();
+		SimRegs.CORDX = CORDX_IDLE;
+	}
+	return &SimRegs;
+}
+
+#undef MATH
+#define MATH (SimMath())
+#include "../Libraries/XMCLib/src/xmc_math.c"
+
+// ----------------------------------------------------------------------------
+//   checks
+// ----------------------------------------------------------------------------
+
+#define RADII                  3
+#define STEPS                  72
+#define COUNT                  (RADII * STEPS + 2)
+
+static const double Radius[RADII] = { 1.0, 37.5, 200.0 };
+
+int main(void)
+{
+	int32_t x[COUNT], y[COUNT];
+	int32_t angle[COUNT], magnitude[COUNT];
+	int32_t irq_angle[COUNT], irq_magnitude[COUNT];
+	XMC_MATH_CORDIC_BATCH_t batch;
+	int quadrant[4] = {0};
+	int failed = 0;
+	int n = 0;
+	int i, r;
+
+	SimRegs.CORDX = CORDX_IDLE;
+
+	// vectors all around the circle, off the axes by 2.5 degrees, and both x axes
+	for (r=0; r<RADII; r++)
+	{
+		for (i=0; i<STEPS; i++, n++)
+		{
+			double theta = (i * 5.0 + 2.5) * M_PI / 180.0 - M_PI;
+			x[n] = (int32_t)lround(Radius[r] * cos(theta) * 32768.0);
+			y[n] = (int32_t)lround(Radius[r] * sin(theta) * 32768.0);
+			quadrant[(y[n] < 0) ? ((x[n] < 0) ? 2 : 3) : ((x[n] < 0) ? 1 : 0)]++;
+		}
+	}
+	x[n] = 3 << 15;  y[n++] = 0;
+	x[n] = -3 << 15; y[n++] = 0;
+
+	XMC_MATH_CORDIC_ArcTanBatch(x, y, angle, magnitude, n);
+
+	batch.op = XMC_MATH_CORDIC_BATCH_OP_ARCTAN;
+	batch.in_x = x;
+	batch.in_y = y;
+	batch.out_a = irq_angle;
+	batch.out_b = irq_magnitude;
+	batch.count = n;
+	XMC_MATH_CORDIC_StartBatch(&batch);
+	while (!XMC_MATH_CORDIC_IsBatchDone(&batch))
+		XMC_MATH_CORDIC_BatchHandler();
+
+	for (i=0; i<n; i++)
+	{
+		double expected = atan2(y[i], x[i]);
+		double error = remainder(Ext24(angle[i]) * M_PI / 8388608.0 - expected, 2.0 * M_PI);
+		double length = sqrt((double)x[i] * x[i] + (double)y[i] * y[i]);
+
+		if ((fabs(error) > 2e-4) || (fabs(magnitude[i] - length) > 2.0 + length * 1e-4) ||
+		    (irq_angle[i] != angle[i]) || (irq_magnitude[i] != magnitude[i]))
+		{
+			if (failed++ < 10)
+				printf("FAIL (%d, %d): angle %.6f expected %.6f, magnitude %d expected %.1f, irq %d %d\n",
+				       (int)x[i], (int)y[i], Ext24(angle[i]) * M_PI / 8388608.0, expected,
+				       (int)magnitude[i], length, (int)irq_angle[i], (int)irq_magnitude[i]);
+		}
+	}
+	if ((Ext24(angle[n-2]) != 0) || ((uint32_t)angle[n-1] != 0x800000U))
+	{
+		printf("FAIL x axis: angles 0x%06x 0x%06x, expected 0 and pi\n", (unsigned)angle[n-2], (unsigned)angle[n-1]);
+		failed++;
+	}
+
+	printf("test_math_cordic: %d of %d vectors failed (quadrants I..IV: %d %d %d %d)\n", failed, n,
+	       quadrant[0], quadrant[1], quadrant[2], quadrant[3]);
+	return failed != 0;
+}
@@ -0,0 +1,105 @@
+/**************************************************************************
+ * @file     test_math_divconst.c
+ * @brief    XMC_MATH_DIV_UnsignedDivConst() against integer division
+ *
+ *           XMC_MATH_DIV_IS_CONSTANT() is wrapped to count the divisions
+ *           that find their divisor constant and, for the exhaustive part,
+ *           to take the reciprocal with divisors that are not. Checked are
+ *           all dividends up to XMC_MATH_DIV_CONST_MAX_DIVIDEND and
+ *           beyond it, with literal divisors through the real compile
+ *           time check and with all divisors up to 2048, those around
+ *           powers of two and random ones through the forced reciprocal.
+ *           Divisors in variables must not take the reciprocal.
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <XMC1300.h>
+
+static int ForceConstant;
+static uint32_t Reciprocals;
+
+#define XMC_MATH_DIV_CONST_RECIPROCAL
+#define XMC_MATH_DIV_IS_CONSTANT(x)    ((ForceConstant || __builtin_constant_p(x)) ? (Reciprocals++, 1) : 0)
+#include "xmc_math.h"
+
+#define DIVIDEND_END           (XMC_MATH_DIV_CONST_MAX_DIVIDEND + 0x400U)
+#define RANDOM_DIVISORS        500
+
+static int Failed;
+
+static void Check(uint32_t dividend, uint32_t divisor, uint32_t quotient)
+{
+	if (quotient != dividend / divisor)
+	{
+		if (Failed++ < 10)
+			printf("FAIL %u / %u = %u, expected %u\n", (unsigned)dividend, (unsigned)divisor,
+			       (unsigned)quotient, (unsigned)(dividend / divisor));
+	}
+}
+
+// Every dividend with a literal divisor, folded by the compiler
+#define CHECK_LITERAL(d)                                                   \
+	for (n=0; n<=DIVIDEND_END; n++)                                        \
+		Check(n, d##U, XMC_MATH_DIV_UnsignedDivConst(n, d##U));            \
+	literals++;
+
+// Every dividend with a divisor only known at run time
+static void CheckDivisor(uint32_t divisor)
+{
+	uint32_t n;
+
+	for (n=0; n<=DIVIDEND_END; n++)
+		Check(n, divisor, XMC_MATH_DIV_UnsignedDivConst(n, divisor));
+}
+
+int main(void)
+{
+	uint32_t state = 0x6C078965U;
+	uint32_t literals = 0;
+	uint32_t divisors = 0;
+	uint32_t n, d, k;
+
+	CHECK_LITERAL(1)     CHECK_LITERAL(2)     CHECK_LITERAL(3)     CHECK_LITERAL(5)
+	CHECK_LITERAL(7)     CHECK_LITERAL(10)    CHECK_LITERAL(12)    CHECK_LITERAL(60)
+	CHECK_LITERAL(100)   CHECK_LITERAL(255)   CHECK_LITERAL(256)   CHECK_LITERAL(257)
+	CHECK_LITERAL(1000)  CHECK_LITERAL(1023)  CHECK_LITERAL(1024)  CHECK_LITERAL(1025)
+	CHECK_LITERAL(10000) CHECK_LITERAL(12345) CHECK_LITERAL(32767) CHECK_LITERAL(32768)
+	CHECK_LITERAL(65535) CHECK_LITERAL(100000)
+	if (Reciprocals != literals * (DIVIDEND_END + 1U))
+	{
+		printf("FAIL %u of %u divisions by literals found the divisor constant\n", (unsigned)Reciprocals,
+		       (unsigned)(literals * (DIVIDEND_END + 1U)));
+		Failed++;
+	}
+
+	Reciprocals = 0;
+	CheckDivisor(3);
+	CheckDivisor(1000);
+	if (Reciprocals != 0U)
+	{
+		printf("FAIL %u divisions by variables found the divisor constant\n", (unsigned)Reciprocals);
+		Failed++;
+	}
+
+	ForceConstant = 1;
+	for (d=1; d<=2048U; d++, divisors++)
+		CheckDivisor(d);
+	for (k=12; k<=20U; k++, divisors+=3)
+	{
+		CheckDivisor((1U << k) - 1U);
+		CheckDivisor(1U << k);
+		CheckDivisor((1U << k) + 1U);
+	}
+	for (n=0; n<RANDOM_DIVISORS; n++, divisors++)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		CheckDivisor(1U + (state & 0xFFFFFU));
+	}
+
+	printf("test_math_divconst: %d failed, dividends 0..0x%X by %u literal and %u forced divisors\n", Failed,
+	       (unsigned)DIVIDEND_END, (unsigned)literals, (unsigned)divisors);
+	return Failed != 0;
+}
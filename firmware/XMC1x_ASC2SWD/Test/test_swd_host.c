@@ -0,0 +1,441 @@
+/**************************************************************************
+ * @file     test_swd_host.c
+ * @brief    swd_host.c against a simulated GPIO port and SWD target
+ *
+ *           SWD_PORT points at SimPort(), which applies the Pn_OMR store
+ *           of the previous GPIO call and sets Pn_IN to the SWDIO level
+ *           before the store of this one, like the input synchronizer
+ *           does. The target model acts on rising SWCLK edges: line reset
+ *           and JTAG to SWD switch, request phase with start, parity, stop
+ *           and park checks, turnarounds, ACK, data and parity. Behind it
+ *           are a DP and a MEM-AP with posted reads, RDBUFF and a TAR that
+ *           wraps at 1 KB, and 16 KB of memory.
+ *
+ *           Checked are the request encoding, WAIT retries, read data
+ *           parity, the order of posted reads and RDBUFF, and the TAR
+ *           writes of block transfers that cross 1 KB boundaries.
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <XMC1300.h>
+#include "xmc_gpio.h"
+
+static XMC_GPIO_PORT_t* SimPort(void);
+
+#define SWD_HOST               1
+#define SWD_PORT               (SimPort())
+#define SWD_SWCLK_PIN          0
+#define SWD_SWDIO_PIN          1
+#include "../swd_host.c"
+
+// ----------------------------------------------------------------------------
+//   target model
+// ----------------------------------------------------------------------------
+
+#define DPIDR                  0x0BB11477
+#define MEM_BASE               0x20000000
+#define MEM_WORDS              4096
+#define TRACE_MAX              4096
+
+// state at the next rising SWCLK edge
+#define T_JTAG                 0   // waiting for the JTAG to SWD switch
+#define T_RESET                1   // line reset, waiting for idle
+#define T_IDLE                 2
+#define T_REQUEST              3
+#define T_TURN_ACK             4   // turnaround before ACK
+#define T_OUT                  5   // target drives ACK or read data
+#define T_TURN_HOST            6   // turnaround back to the host
+#define T_WRITE                7   // write data and parity
+
+typedef struct
+{
+	BYTE request;              // APnDP, RnW, A[3:2] as SWD_REQ_xxx
+	BYTE ack;
+	DWORD data;
+} TRACE;
+
+static XMC_GPIO_PORT_t SimRegs;
+static UINT HostDrives = 1;
+static UINT PinOut = 0x3;      // output levels, SWCLK and SWDIO idle high
+
+static UINT State = T_JTAG;
+static UINT Ones;              // consecutive ones driven by the host
+static UINT LineReset;         // 50 ones seen since the last idle
+static DWORD Shift;
+static UINT Bits;
+static BYTE Request;
+static BYTE Ack;
+static unsigned long long Out; // bits the target drives, LSB next
+static UINT OutBits;
+static UINT TargetDrives;
+static UINT TargetLevel;
+
+static DWORD Mem[MEM_WORDS];
+static DWORD Tar;
+static DWORD Csw;
+static DWORD Select;
+static DWORD ReadBuf;          // posted AP read result, RDBUFF
+static UINT WaitCount;         // WAIT answers before the next AP access goes through
+static UINT FlipParity;        // send the next read data with a wrong parity
+
+static TRACE Trace[TRACE_MAX];
+static UINT TraceCount;
+static UINT Errors;            // protocol violations seen by the model
+
+static void Error(const char* what)
+{
+	if (Errors++ < 10)
+		printf("  model: %s (state %u, trace %u)\n", what, State, TraceCount);
+}
+
+static DWORD Parity(DWORD value)
+{
+	value ^= value >> 16;
+	value ^= value >> 8;
+	value ^= value >> 4;
+	value ^= value >> 2;
+	value ^= value >> 1;
+	return value & 1;
+}
+
+// TAR auto increment only carries within the 1 KB block
+static DWORD* MemWord(void)
+{
+	DWORD* word = 0;
+
+	if ((Tar >= MEM_BASE) && (Tar < MEM_BASE + MEM_WORDS * 4))
+		word = &Mem[(Tar - MEM_BASE) / 4];
+	else
+		Error("access outside the memory");
+	Tar = (Tar & ~(DWORD)(SWD_TAR_WRAP - 1)) | ((Tar + 4) & (SWD_TAR_WRAP - 1));
+	return word;
+}
+
+// Data phase of a read with ACK OK: AP reads return the previous result
+static DWORD ReadRegister(void)
+{
+	DWORD value = 0;
+	DWORD* word;
+
+	if (Request & SWD_REQ_APnDP) {
+		value = ReadBuf;
+		switch (Request & SWD_REQ_ADDR) {
+		case SWD_AP_CSW: ReadBuf = Csw; break;
+		case SWD_AP_TAR: ReadBuf = Tar; break;
+		case SWD_AP_DRW:
+			word = MemWord();
+			ReadBuf = word ? *word : 0;
+			break;
+		default: ReadBuf = 0; break;
+		}
+	}
+	else {
+		switch (Request & SWD_REQ_ADDR) {
+		case SWD_DP_DPIDR: value = DPIDR; break;
+		case SWD_DP_SELECT: value = Select; break;
+		case SWD_DP_RDBUFF: value = ReadBuf; break;
+		default: value = 0; break;
+		}
+	}
+	Trace[TraceCount-1].data = value;
+	return value;
+}
+
+static void WriteRegister(DWORD value)
+{
+	DWORD* word;
+
+	Trace[TraceCount-1].data = value;
+	if (Request & SWD_REQ_APnDP) {
+		switch (Request & SWD_REQ_ADDR) {
+		case SWD_AP_CSW: Csw = value; break;
+		case SWD_AP_TAR: Tar = value; break;
+		case SWD_AP_DRW:
+			word = MemWord();
+			if (word)
+				*word = value;
+			break;
+		}
+	}
+	else if ((Request & SWD_REQ_ADDR) == SWD_DP_SELECT)
+		Select = value;
+}
+
+// Request phase complete: [0] start, [1] APnDP, [2] RnW, [3..4] A[2:3],
+// [5] parity, [6] stop, [7] park
+static void Respond(void)
+{
+	Request = (BYTE)((Shift >> 1) & 0x0F);
+	if (!(Shift & 0x01) || (((Shift >> 5) & 1) != Parity(Request)) || (Shift & 0x40) || !(Shift & 0x80)) {
+		Error("bad request");
+		State = T_IDLE;
+		return;
+	}
+	Ack = SWD_ACK_OK;
+	if ((Request & SWD_REQ_APnDP) && WaitCount) {
+		WaitCount--;
+		Ack = SWD_ACK_WAIT;
+	}
+	if (TraceCount < TRACE_MAX) {
+		Trace[TraceCount].request = Request;
+		Trace[TraceCount].ack = Ack;
+		Trace[TraceCount].data = 0;
+		TraceCount++;
+	}
+	State = T_TURN_ACK;
+}
+
+static void RisingEdge(UINT swdio)
+{
+	UINT host = HostDrives;
+	DWORD value;
+
+	// the host must drive outside of the turnarounds and the target phases
+	if (host != ((State <= T_REQUEST) || (State == T_WRITE)))
+		Error(host ? "host drives SWDIO during a target phase" : "SWDIO floats during a host phase");
+
+	if (host) {
+		Ones = swdio ? Ones + 1 : 0;
+		if (Ones >= 50) {
+			LineReset = 1;
+			if (State != T_JTAG)
+				State = T_RESET;
+		}
+	}
+
+	switch (State) {
+	case T_JTAG:
+		Shift = (Shift >> 1) | ((DWORD)swdio << 15);
+		if ((Shift & 0xFFFF) == SWD_JTAG_TO_SWD) {
+			LineReset = 0;
+			State = T_RESET;
+		}
+		break;
+	case T_RESET:
+		// the switch has to be followed by a line reset and an idle cycle
+		if (!swdio && LineReset) {
+			LineReset = 0;
+			State = T_IDLE;
+		}
+		break;
+	case T_IDLE:
+		if (swdio) {
+			Shift = 1;
+			Bits = 1;
+			State = T_REQUEST;
+		}
+		break;
+	case T_REQUEST:
+		Shift |= (DWORD)swdio << Bits;
+		if (++Bits == 8)
+			Respond();
+		break;
+	case T_TURN_ACK:
+		Out = Ack;
+		OutBits = 3;
+		if ((Ack == SWD_ACK_OK) && (Request & SWD_REQ_RnW)) {
+			value = ReadRegister();
+			Out |= (unsigned long long)value << 3;
+			Out |= (unsigned long long)(Parity(value) ^ FlipParity) << 35;
+			OutBits = 36;
+			FlipParity = 0;
+		}
+		State = T_OUT;
+		// fall through, the first bit is driven after this edge
+	case T_OUT:
+		if (OutBits) {
+			TargetDrives = 1;
+			TargetLevel = Out & 1;
+			Out >>= 1;
+			OutBits--;
+		}
+		else {
+			TargetDrives = 0;
+			State = T_TURN_HOST;
+		}
+		break;
+	case T_TURN_HOST:
+		Bits = 0;
+		Shift = 0;
+		State = ((Ack == SWD_ACK_OK) && !(Request & SWD_REQ_RnW)) ? T_WRITE : T_IDLE;
+		break;
+	case T_WRITE:
+		if (Bits < 32)
+			Shift |= (DWORD)swdio << Bits;
+		else {
+			if (swdio != Parity(Shift))
+				Error("write data parity");
+			WriteRegister(Shift);
+			State = T_IDLE;
+		}
+		Bits++;
+		break;
+	}
+}
+
+// Applies the store to Pn_OMR of the previous GPIO call, then sets Pn_IN to
+// the level of SWDIO before the store the caller is about to do. Pn_OMR
+// set and clear of the same pin toggles it.
+static XMC_GPIO_PORT_t* SimPort(void)
+{
+	DWORD omr = SimRegs.OMR;
+	UINT before = PinOut;
+	UINT swdio;
+
+	if (omr) {
+		PinOut = (PinOut | (omr & 0xFFFF)) & ~((omr >> 16) & ~omr);
+		PinOut ^= omr & (omr >> 16) & 0xFFFF;
+		SimRegs.OMR = 0;
+		if (!(before & SWCLK) && (PinOut & SWCLK))
+			RisingEdge((PinOut & SWDIO) ? 1 : 0);
+	}
+	swdio = HostDrives ? (PinOut & SWDIO) : ((TargetDrives && !TargetLevel) ? 0 : SWDIO);
+	*(volatile uint32_t*)&SimRegs.IN = (PinOut & SWCLK) | swdio;
+	return &SimRegs;
+}
+
+void XMC_GPIO_SetMode(XMC_GPIO_PORT_t *const port, const uint8_t pin, const XMC_GPIO_MODE_t mode)
+{
+	if (pin == SWD_SWDIO_PIN)
+		HostDrives = (mode == XMC_GPIO_MODE_OUTPUT_PUSH_PULL);
+}
+
+// ----------------------------------------------------------------------------
+//   checks
+// ----------------------------------------------------------------------------
+
+static int Failed;
+
+static void Check(int ok, const char* what)
+{
+	if (!ok) {
+		printf("FAIL %s\n", what);
+		Failed++;
+	}
+}
+
+static void Connect(void)
+{
+	DWORD id = 0;
+
+	Check(SwdHost_Connect(&id) == SWD_ACK_OK, "connect ACK");
+	Check(id == DPIDR, "DPIDR read after connect");
+}
+
+// Compares the trace of a block transfer of count words at addr with TAR
+// writes on 1 KB boundaries and, for reads, the posted DRW reads and RDBUFF
+static void CheckBlockTrace(DWORD addr, UINT count, int read, const char* what)
+{
+	UINT t = 0;
+	UINT n, i;
+	int ok = 1;
+
+	while (count && ok) {
+		n = (SWD_TAR_WRAP - (addr & (SWD_TAR_WRAP - 1))) / 4;
+		if (n > count)
+			n = count;
+		ok &= (Trace[t].request == (SWD_REQ_APnDP | SWD_AP_TAR)) && (Trace[t].data == addr);
+		t++;
+		for (i=0; i<n; i++, t++)
+			ok &= Trace[t].request == (SWD_REQ_APnDP | SWD_AP_DRW | (read ? SWD_REQ_RnW : 0));
+		if (read)
+			ok &= Trace[t++].request == (SWD_REQ_RnW | SWD_DP_RDBUFF);
+		addr += n * 4;
+		count -= n;
+	}
+	if (!read)
+		ok &= Trace[t++].request == (SWD_REQ_RnW | SWD_DP_RDBUFF);
+	ok &= (t == TraceCount);
+	Check(ok, what);
+}
+
+// Applies the last clock edge of the transfer before the trace is checked
+static BYTE Transfer(BYTE request, DWORD* data)
+{
+	BYTE ack = SwdHost_Transfer(request, data);
+
+	(void)SimPort();
+	return ack;
+}
+
+int main(void)
+{
+	DWORD buf[700];
+	DWORD value;
+	UINT i, req;
+	int ok;
+
+	SimRegs.OMR = 0;
+
+	// line reset, switch and DPIDR
+	Connect();
+
+	// every combination of APnDP, RnW and A[3:2] decodes as requested
+	ok = 1;
+	for (req=0; req<16; req++) {
+		Tar = MEM_BASE;
+		value = (req & SWD_REQ_ADDR) == SWD_AP_TAR ? MEM_BASE : 0x1234 + req;
+		TraceCount = 0;
+		ok &= (Transfer((BYTE)req, &value) == SWD_ACK_OK) && (TraceCount == 1) && (Trace[0].request == req);
+	}
+	Check(ok, "request encoding and parity");
+
+	// read data with a wrong parity is reported and not stored
+	value = 0xDEAD;
+	FlipParity = 1;
+	Check(Transfer(SWD_REQ_RnW | SWD_DP_DPIDR, &value) == SWD_ACK_PARITY, "read data parity error reported");
+	Check(value == 0xDEAD, "read data with a parity error not stored");
+
+	// WAIT is retried up to SWD_WAIT_RETRIES times
+	Csw = 0x23000052;
+	TraceCount = 0;
+	WaitCount = 5;
+	Tar = 0;
+	value = MEM_BASE + 0x10;
+	Check(Transfer(SWD_REQ_APnDP | SWD_AP_TAR, &value) == SWD_ACK_OK, "WAIT retried");
+	Check((TraceCount == 6) && (Tar == MEM_BASE + 0x10), "WAIT retry repeats the request until OK");
+	TraceCount = 0;
+	WaitCount = SWD_WAIT_RETRIES + 1;
+	Check(Transfer(SWD_REQ_APnDP | SWD_AP_TAR, &value) == SWD_ACK_WAIT, "WAIT after the retries");
+	Check(TraceCount == SWD_WAIT_RETRIES + 1, "WAIT retry count");
+	WaitCount = 0;
+
+	// posted reads: the first DRW read returns stale data, RDBUFF the last word
+	for (i=0; i<MEM_WORDS; i++)
+		Mem[i] = 0xA5000000 ^ (i * 0x9E3779B1U);
+	for (i=0; i<4; i++)
+		buf[i] = 0;
+	TraceCount = 0;
+	Check(SwdHost_ReadBlock(MEM_BASE + 0x100, buf, 4) == SWD_ACK_OK, "short block read");
+	Check(!memcmp(buf, &Mem[0x40], 4 * 4), "short block read data");
+	CheckBlockTrace(MEM_BASE + 0x100, 4, 1, "posted DRW reads closed by RDBUFF");
+
+	// block transfers across 1 KB boundaries write TAR again
+	TraceCount = 0;
+	memset(buf, 0, sizeof(buf));
+	Check(SwdHost_ReadBlock(MEM_BASE + 0x3F0, buf, 700) == SWD_ACK_OK, "block read over 1 KB boundaries");
+	Check(!memcmp(buf, &Mem[0x3F0 / 4], sizeof(buf)), "block read data over 1 KB boundaries");
+	CheckBlockTrace(MEM_BASE + 0x3F0, 700, 1, "TAR written per 1 KB segment of a read");
+
+	for (i=0; i<700; i++)
+		buf[i] = 0x5A000000 + i;
+	TraceCount = 0;
+	Check(SwdHost_WriteBlock(MEM_BASE + 0x1FFC, buf, 700) == SWD_ACK_OK, "block write over 1 KB boundaries");
+	Check(!memcmp(&Mem[0x1FFC / 4], buf, sizeof(buf)), "block write data over 1 KB boundaries");
+	Check(Mem[0x1FF8 / 4] == (0xA5000000 ^ ((0x1FF8 / 4) * 0x9E3779B1U)), "block write stays in its range");
+	CheckBlockTrace(MEM_BASE + 0x1FFC, 700, 0, "TAR written per 1 KB segment of a write, RDBUFF at the end");
+
+	// the same with WAIT answers in between
+	TraceCount = 0;
+	WaitCount = 3;
+	memset(buf, 0, sizeof(buf));
+	Check(SwdHost_ReadBlock(MEM_BASE + 0x1FFC, buf, 300) == SWD_ACK_OK, "block read with WAIT");
+	Check(buf[0] == 0x5A000000 && buf[299] == 0x5A000000 + 299, "block read data with WAIT");
+
+	(void)SimPort();
+	Check(Errors == 0, "no protocol violations seen by the target");
+	printf("test_swd_host: %d failed\n", Failed);
+	return Failed != 0;
+}
@@ -0,0 +1,92 @@
+/**************************************************************************
+ * @file     test_usic_baud.c
+ * @brief    XMC_USIC_CH_GetBaudrateDivider() against the old STEP loop
+ *
+ *           The reference is the search XMC_USIC_CH_SetBaudrate() did
+ *           before, one division per STEP, limited to PDIV + 1 >= 1 (the
+ *           old loop wrote an underflowed PDIV otherwise) and failing when
+ *           no STEP below 1024 gives a PDIV.
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../Libraries/XMCLib/src/xmc_usic.c"
+
+static XMC_USIC_CH_STATUS_t Reference(uint32_t peripheral_clock, uint32_t rate, uint32_t oversampling,
+                                      XMC_USIC_CH_BAUDRATE_DIVIDER_t* divider)
+{
+	uint32_t clock = peripheral_clock / 100U;
+	uint32_t quanta = (rate / 100U) * oversampling;
+	uint32_t step, pdiv, pdiv_int, pdiv_frac;
+	uint32_t step_min = 0, pdiv_int_min = 0, pdiv_frac_min = 0x3ffU;
+
+	if ((rate < 100U) || (oversampling == 0U))
+		return XMC_USIC_CH_STATUS_ERROR;
+
+	for (step = 1023U; step > 0U; --step)
+	{
+		pdiv = (uint32_t)(((uint64_t)clock * step) / quanta);
+		pdiv_int = pdiv >> 10U;
+		pdiv_frac = pdiv & 0x3ffU;
+		if ((pdiv_int >= 1U) && (pdiv_int < 1024U) && (pdiv_frac < pdiv_frac_min))
+		{
+			pdiv_frac_min = pdiv_frac;
+			pdiv_int_min = pdiv_int;
+			step_min = step;
+		}
+	}
+	if (pdiv_int_min == 0U)
+		return XMC_USIC_CH_STATUS_ERROR;
+
+	divider->step = (uint16_t)step_min;
+	divider->pdiv = (uint16_t)(pdiv_int_min - 1U);
+	return XMC_USIC_CH_STATUS_OK;
+}
+
+static int Check(uint32_t clock, uint32_t rate, uint32_t oversampling)
+{
+	XMC_USIC_CH_BAUDRATE_DIVIDER_t got = {0, 0};
+	XMC_USIC_CH_BAUDRATE_DIVIDER_t ref = {0, 0};
+	XMC_USIC_CH_STATUS_t got_status = XMC_USIC_CH_GetBaudrateDivider(clock, rate, oversampling, &got);
+	XMC_USIC_CH_STATUS_t ref_status = Reference(clock, rate, oversampling, &ref);
+
+	if ((got_status == ref_status) &&
+	    ((got_status != XMC_USIC_CH_STATUS_OK) || ((got.step == ref.step) && (got.pdiv == ref.pdiv))))
+		return 0;
+
+	printf("FAIL clock %u rate %u oversampling %u: status %d step %u pdiv %u, expected status %d step %u pdiv %u\n",
+	       (unsigned)clock, (unsigned)rate, (unsigned)oversampling, (int)got_status, got.step, got.pdiv,
+	       (int)ref_status, ref.step, ref.pdiv);
+	return 1;
+}
+
+int main(void)
+{
+	static const uint32_t clocks[] = {8000000, 16000000, 32000000, 48000000, 64000000};
+	static const uint32_t rates[] = {9600, 57600, 115200, 230400, 460800, 921600, 1000000, 2000000};
+	int failed = 0;
+	int checked = 0;
+	unsigned int i, j, k;
+
+	for (i=0; i<sizeof(clocks)/sizeof(clocks[0]); i++)
+		for (j=0; j<sizeof(rates)/sizeof(rates[0]); j++)
+			for (k=1; k<=16; k++, checked++)
+				failed += Check(clocks[i], rates[j], k);
+
+	// no STEP below 1024: quanta == clock, and a first STEP of exactly 1024
+	failed += Check(16000000, 1000000, 16);
+	failed += Check(32000000, 2000000, 16);
+	failed += Check(16000000, 999400, 16);
+	failed += Check(8000000, 15990000, 1);
+	checked += 4;
+
+	srand(1);
+	for (i=0; i<200000; i++, checked++)
+		failed += Check(1000000 + (uint32_t)rand() % 63000000, 100 + (uint32_t)rand() % 4000000,
+		                1 + (uint32_t)rand() % 32);
+
+	printf("test_usic_baud: %d of %d failed\n", failed, checked);
+	return failed != 0;
+}
@@ -0,0 +1,101 @@
+/**************************************************************************
+ * @file     asc_transport.h
+ * @brief    UART (ASC) transport of the XMC1000 Bootloader
+ *
+ *           The USIC channel, its pins and the FIFO layout are selected at
+ *           compile time with ASC_CHANNEL, so the receive and transmit
+ *           loops compile down to accesses of one fixed register block:
+ *
+ *             ASC_CHANNEL 0     USIC0_CH0, P0.14 (RX) / P0.15 (TX)  default
+ *             ASC_CHANNEL 1     USIC0_CH1, P1.3 (RX) / P1.2 (TX)
+ *             ASC_CHANNEL_AUTO  channel the ROM BSL was started on, looked
+ *                               up once by ASC_Init()
+ *
+ **************************************************************************/
+
+#ifndef __ASC_TRANSPORT_H__
+#define __ASC_TRANSPORT_H__
+
+#include <XMC1300.h>
+#include "flasher.h"
+
+// ----------------------------------------------------------------------------
+//   channel selection
+// ----------------------------------------------------------------------------
+
+#define ASC_CHANNEL_AUTO       0xFF
+
+#ifndef ASC_CHANNEL
+#define ASC_CHANNEL            0
+#endif
+
+#if ASC_CHANNEL == 0
+#define ASC_CH                 USIC0_CH0
+#elif ASC_CHANNEL == 1
+#define ASC_CH                 USIC0_CH1
+#elif ASC_CHANNEL == ASC_CHANNEL_AUTO
+extern USIC_CH_TypeDef* AscChannel;
+#define ASC_CH                 AscChannel
+#else
+#error "ASC_CHANNEL must be 0, 1 or ASC_CHANNEL_AUTO"
+#endif
+
+// receive polls without a byte after which ASC_Drain() takes the line as idle,
+// a few ms at 8..32 MHz MCLK, longer than the gaps of USB serial adapters
+#define ASC_IDLE_POLLS         20000
+
+// input stage DX0 source (DSEL) and FIFO layout set by ASC_Init(). The
+// receive FIFO holds 32 bytes (~350 us at 921600 baud) so that flash polling
+// between two reads of a windowed program session cannot drop a byte.
+#define ASC_DX0_DSEL           0
+#define ASC_TBCTR_DPTRSIZE     0x01000000   // DPTR = 0, SIZE = 1
+#define ASC_RBCTR_DPTRSIZE     0x05000020   // DPTR = 32, SIZE = 5
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+void ASC_Init(void);
+
+__STATIC_INLINE int ASC_RxEmpty(void)
+{
+	return (ASC_CH->TRBSR & USIC_CH_TRBSR_REMPTY_Msk) != 0;
+}
+
+__STATIC_INLINE BYTE ASC_GetByte(void)
+{
+	while(ASC_RxEmpty()) {};
+	return (BYTE)(ASC_CH->OUTR & 0xFF);
+}
+
+__STATIC_INLINE void ASC_PutByte(BYTE data)
+{
+	while(!(ASC_CH->TRBSR & USIC_CH_TRBSR_TEMPTY_Msk)) {};
+	ASC_CH->IN[0] = data;
+}
+
+// discards received bytes until the line has been idle for ASC_IDLE_POLLS
+__STATIC_INLINE void ASC_Drain(void)
+{
+	UINT idle = ASC_IDLE_POLLS;
+
+	while (idle)
+	{
+		if (ASC_RxEmpty())
+			idle--;
+		else
+		{
+			(void)ASC_CH->OUTR;
+			idle = ASC_IDLE_POLLS;
+		}
+	}
+}
+
+// waits until the last frame has left the shift register
+__STATIC_INLINE void ASC_Flush(void)
+{
+	while(!(ASC_CH->TRBSR & USIC_CH_TRBSR_TEMPTY_Msk)) {};
+	while(ASC_CH->PSR_ASCMode & USIC_CH_PSR_ASCMode_BUSY_Msk) {};
+}
+
+#endif  // __ASC_TRANSPORT_H__
@@ -27,6 +27,18 @@
 
 // TYPE:   Type definitions ------------------------------------------------
 
+// Session state of the loader command loop. A header block is only accepted
+// in SESSION_IDLE; BSL_PROGRAM_FLASH switches to SESSION_PROGRAM (or
+// SESSION_WINDOW) until the EOT block arrives.
+typedef enum tagSessionState
+{
+	SESSION_IDLE = 0,       // waiting for a header block
+	SESSION_PROGRAM,        // receiving data blocks of a program request
+	SESSION_WINDOW          // program request with BSL_PROG_WINDOW
+} SESSION_STATE;
+
+// Command handler, called with a validated header in HeaderBlock[]
+typedef SESSION_STATE (*BSL_HANDLER)(void);
 
 // MACRO:  Return codes ------------------------------------------------
 //   Return codes emitted by the flasher functions.
@@ -54,6 +66,17 @@ typedef unsigned long long QWORD;
 //FLASH CONSTANTS
 
 #define PAGE_SIZE        	   256   // program FLASH page size
+#define FLASH_ERASED_WORD      0xFFFFFFFF  // read value of an erased flash word
+
+// external SPI NOR flash as staging area (spi_flash.c), 0 = not built in
+#ifndef SPI_FLASH
+#define SPI_FLASH              0
+#endif
+
+// bit-banged SWD host for a second target (swd_host.c), 0 = not built in
+#ifndef SWD_HOST
+#define SWD_HOST               0
+#endif
 
 //BSL CONSTANTS
 
@@ -68,6 +91,49 @@ typedef unsigned long long QWORD;
 #define BSL_CHANGE_BMI         0x01
 #define BSL_ERASE_FLASH        0x03
 #define BSL_READ_FLASH         0x04
+#define BSL_GET_STATS          0x05
+#define BSL_FINALIZE           0x06  // CRC check of the image, then BMI change
+#define BSL_GET_INFO           0x07  // protocol version, features and chip geometry
+#define BSL_STAGE_COMMIT       0x08  // program the flash from the SPI flash staging area
+#define BSL_SWD                0x09  // DP/AP accesses of a target on the SWD host pins
+#define BSL_MODE_COUNT         0x0A  // size of the command table (HeaderBlock[1] range)
+
+// reported by BSL_GET_INFO, raised when a command or reply changes incompatibly
+#define BSL_PROTOCOL_VERSION   0x01
+
+// BSL_GET_INFO pages, HeaderBlock[2]
+#define BSL_INFO_LOADER        0x00  // commands, program options, buffers and MCLK
+#define BSL_INFO_CHIP          0x01  // flash geometry and chip ID
+#define BSL_INFO_STAGE         0x02  // SPI flash ID and size, SPI_FLASH builds only
+
+// BSL_SWD operations, HeaderBlock[2] (SWD_HOST builds only)
+#define BSL_SWD_CONNECT        0x00  // line reset and DPIDR read, [3] = clock delay
+#define BSL_SWD_TRANSFER       0x01  // [3] = number of request records that follow
+#define BSL_SWD_READ_BLOCK     0x02  // [3..6] word address, [7] number of words
+#define BSL_SWD_WRITE_BLOCK    0x03  // [3..6] word address, [7] number of words that follow
+#define BSL_SWD_BATCH_MAX      48    // records per BSL_SWD_TRANSFER, buffered in DataRx
+#define BSL_SWD_BLOCK_MAX      (PAGE_SIZE/4)  // words per block access, buffered in DataRx
+
+// BSL_GET_STATS pages, HeaderBlock[2]
+#define BSL_STATS_SRAM         0x00  // stack and page buffer budget
+#define BSL_STATS_POOL         0x01  // block pool occupancy, HeaderBlock[3] = pool
+
+// BSL_PROGRAM_FLASH options, HeaderBlock[6]
+#define BSL_PROG_ERASED        0x01  // target pages were erased, use continuous write
+#define BSL_PROG_VERIFY        0x02  // separate verify pass after continuous write
+#define BSL_PROG_LAZY_ERASE    0x04  // erase each sector when its first page arrives
+#define BSL_PROG_SEQUENCE      0x08  // data block byte 1 is a sequence number, replies
+                                     // carry the number of the block they refer to
+#define BSL_PROG_WINDOW        0x10  // up to window blocks unacknowledged, implies
+                                     // BSL_PROG_SEQUENCE, ACKs are cumulative; needs
+                                     // ERASED, LAZY_ERASE or STAGE (background writes)
+#define BSL_PROG_STAGE         0x20  // pages go to the SPI flash staging area, see
+                                     // BSL_STAGE_COMMIT (SPI_FLASH builds only)
+#if SPI_FLASH
+#define BSL_PROG_SUPPORTED     0x3F  // options this loader knows, see BSL_GET_INFO
+#else
+#define BSL_PROG_SUPPORTED     0x1F
+#endif
 
 #define BSL_BLOCK_TYPE_ERROR     0xFF
 #define BSL_MODE_ERROR 		     0xFE 
@@ -75,6 +141,10 @@ typedef unsigned long long QWORD;
 #define BSL_ADDRESS_ERROR 	     0xFC
 #define BSL_ERASE_ERROR		     0xFB
 #define BSL_PROGRAM_ERROR	     0xFA
+#define BSL_BMI_ERROR		     0xF9
+#define BSL_VERIFY_ERROR	     0xF8
+#define BSL_SEQUENCE_ERROR	     0xF7
+#define BSL_SWD_ERROR		     0xF6
 #define BSL_SUCCESS 		     0x55
 #define BSL_ERASE_SUCCESS 		 0x50
 
@@ -0,0 +1,132 @@
+##############################################################################
+# loader.mk - size optimized build of the SRAM loader
+#
+# The loader is uploaded through the ROM ASC BSL before anything else can
+# happen, so every byte of the image costs upload time. This profile builds
+# the same sources as the DAVE project with -Os, LTO and section garbage
+# collection (only the XMCLib code that is referenced ends up in SRAM_1).
+#
+#   make -f loader.mk                 build Loader/XMC1x_ASC2SWD.elf/.bin
+#   make -f loader.mk size            size report per object and image
+#   make -f loader.mk size-check      fail if an object exceeds its budget
+#   make -f loader.mk size-baseline   write loader_size.budget from this build
+#   make -f loader.mk chain           Stage1/stage1.c and the loader linked as
+#                                     its second stage (above stage 1 in SRAM)
+#
+##############################################################################
+
+PREFIX  ?= arm-none-eabi-
+CC      := $(PREFIX)gcc
+OBJCOPY := $(PREFIX)objcopy
+SIZE    := $(PREFIX)size
+
+BUILD   := Loader
+TARGET  := $(BUILD)/XMC1x_ASC2SWD
+BUDGET  := loader_size.budget
+# headroom added by size-baseline, in percent
+BUDGET_SLACK ?= 5
+# USIC channel of the UART: 0 (P0.14/P0.15), 1 (P1.3/P1.2) or ASC_CHANNEL_AUTO
+ASC_CHANNEL ?= 0
+# 1: SPI NOR staging area on the other USIC0 channel (spi_flash.c), needs ASC_CHANNEL 0 or 1
+SPI_FLASH ?= 0
+# 1: bit-banged SWD host on P0.0 (SWCLK) / P0.1 (SWDIO) for a second target (swd_host.c)
+SWD_HOST ?= 0
+
+SRCS := main.c ASC_Init.c xmc1000_flasher.c sram_budget.c mem_pool.c spi_flash.c swd_host.c \
+        Libraries/Newlib/syscalls.c \
+        $(wildcard Libraries/XMCLib/src/*.c)
+ASRCS := Startup/startup_XMC1300.S
+
+INCS := -I. -IDave/Generated -ILibraries/XMCLib/inc -ILibraries/CMSIS/Include \
+        -ILibraries/CMSIS/Infineon/XMC1300_series/Include
+
+ARCH    := -mcpu=cortex-m0 -mthumb -mno-thumb-interwork -mfloat-abi=soft
+CFLAGS  := $(ARCH) -Os -std=gnu99 -Wall -ffunction-sections -fdata-sections \
+           -flto -ffat-lto-objects -DXMC1302_Q040x0128 -DASC_CHANNEL=$(ASC_CHANNEL) \
+           -DSPI_FLASH=$(SPI_FLASH) -DSWD_HOST=$(SWD_HOST) $(INCS)
+ASFLAGS := $(ARCH) -x assembler-with-cpp $(INCS)
+LDFLAGS := $(ARCH) -Os -flto -nostartfiles --specs=nano.specs -Wl,--gc-sections
+
+# two stage chain: stage 1 occupies the first 0x400 bytes of SRAM_1
+STAGE1  := $(BUILD)/stage1
+STAGE2  := $(TARGET)_stage2
+
+OBJS := $(addprefix $(BUILD)/,$(notdir $(SRCS:.c=.o) $(ASRCS:.S=.o)))
+vpath %.c $(sort $(dir $(SRCS)))
+vpath %.S $(sort $(dir $(ASRCS)))
+
+# the objects depend on the headers they include (-MMD) and on the build
+# options: the stamp changes with ASC_CHANNEL, SPI_FLASH, SWD_HOST or any
+# other flag, so switching them rebuilds instead of linking stale objects
+STAMP   := $(BUILD)/flags.stamp
+STAMP_FLAGS := $(CC) $(CFLAGS) $(ASFLAGS) $(LDFLAGS)
+
+# __aeabi_uidiv & co. are only referenced by code generation, LTO would
+# drop the MATH coprocessor versions in favour of libgcc
+$(BUILD)/xmc_math.o: CFLAGS += -fno-lto
+
+all: $(TARGET).bin size
+
+$(BUILD):
+	mkdir -p $@
+
+$(STAMP): FORCE | $(BUILD)
+	@echo '$(STAMP_FLAGS)' | cmp -s - $@ || echo '$(STAMP_FLAGS)' > $@
+
+$(BUILD)/%.o: %.c $(STAMP) | $(BUILD)
+	$(CC) $(CFLAGS) -MMD -MP -c $< -o $@
+
+$(BUILD)/%.o: %.S $(STAMP) | $(BUILD)
+	$(CC) $(ASFLAGS) -MMD -MP -c $< -o $@
+
+$(TARGET).elf: $(OBJS) linker_script.ld
+	$(CC) $(LDFLAGS) -T linker_script.ld -Wl,-Map=$(TARGET).map $(OBJS) -o $@
+
+%.bin: %.elf
+	$(OBJCOPY) -O binary $< $@
+
+chain: $(STAGE1).bin $(STAGE2).bin
+	@$(SIZE) $(STAGE1).elf $(STAGE2).elf
+
+$(STAGE1).elf: Stage1/stage1.c Stage1/stage1.ld $(STAMP) | $(BUILD)
+	$(CC) $(ARCH) -MMD -MP -Os -std=gnu99 -Wall -ffunction-sections -nostartfiles -nostdlib \
+		-DXMC1302_Q040x0128 -DASC_CHANNEL=$(ASC_CHANNEL) $(INCS) -T Stage1/stage1.ld -Wl,--gc-sections $< -o $@
+
+$(BUILD)/stage2.ld: linker_script.ld | $(BUILD)
+	sed -e 's/ORIGIN = 0x20000200, LENGTH = 0x3E00/ORIGIN = 0x20000600, LENGTH = 0x3A00/' $< > $@
+
+$(STAGE2).elf: $(OBJS) $(BUILD)/stage2.ld
+	$(CC) $(LDFLAGS) -T $(BUILD)/stage2.ld -Wl,-Map=$(STAGE2).map $(OBJS) -o $@
+
+size: $(TARGET).bin
+	@$(SIZE) $(OBJS)
+	@$(SIZE) -A $(TARGET).elf | grep -E "^\.(text|ARM.exidx|rodata|data|bss) "
+	@echo "upload size: `wc -c < $(TARGET).bin` bytes"
+
+# budget lines: <object> <max text+data bytes>, and <image>.bin <max upload
+# bytes>. The image limit is the SRAM_1 region of the two stage chain
+# (0x3A00, the smaller one). size-check fails for objects without a line, so
+# a new object, or a budget without per object lines, needs size-baseline.
+SIZES = { $(SIZE) $(OBJS); echo "`wc -c < $(TARGET).bin` 0 0 0 0 $(TARGET).bin"; }
+
+size-check: $(OBJS) $(TARGET).bin
+	@test -f $(BUDGET) || { echo "$(BUDGET) missing, run size-baseline"; exit 1; }
+	@$(SIZES) | awk 'NR == FNR { budget[$$1] = $$2; next } \
+		FNR > 1 { n = $$6; sub(".*/", "", n); \
+		if (!(n in budget)) { \
+			print n ": no budget line, run size-baseline"; bad = 1 } \
+		else if ($$1 + $$2 > budget[n]) { \
+			print n ": " $$1 + $$2 " bytes, budget " budget[n]; bad = 1 } } \
+		END { exit bad }' $(BUDGET) -
+
+size-baseline: $(OBJS) $(TARGET).bin
+	@$(SIZES) | awk 'FNR > 1 { n = $$6; sub(".*/", "", n); \
+		print n, int(($$1 + $$2) * (100 + $(BUDGET_SLACK)) / 100) }' > $(BUDGET)
+	@cat $(BUDGET)
+
+clean:
+	rm -rf $(BUILD)
+
+-include $(wildcard $(BUILD)/*.d)
+
+.PHONY: all size size-check size-baseline chain clean FORCE
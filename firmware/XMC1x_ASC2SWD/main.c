@@ -11,7 +11,7 @@
 **		  -Program flash		                                                *
 **      -Read flash       			                                          *
 **		  -Change BMI value                                                 *
-**		  -Using P1.3 (RX) and P1.2 (TX) for ASC communication              *
+**		  -ASC channel and pins selected by ASC_CHANNEL (asc_transport.h)  *
 **  	                                                                    *
 **  VERSION : V1.1							                                          *
 **                                                                        *
@@ -47,84 +47,87 @@
 ****************************************************************************
 V1.0 , May 2013, First version
 V1.1 , May 2015, Second version: Read Flash function, Segger rework
+V1.2 , Table driven command loop, BMI change on host request
 ***************************************************************************/
 
 #include <XMC1300.h>
 #include "xmc1000_flasher.h"
+#include "sram_budget.h"
+#include "mem_pool.h"
+#include "asc_transport.h"
+#include "spi_flash.h"
+#include "swd_host.h"
 //#include "XMC1000_RomFunctionTable.h"
 
 BYTE HeaderBlock[HEADER_BLOCK_SIZE];
-unsigned int DataRx[69] = {0};    // make sure the DataRx[] is 4 byte aligned
+unsigned int* DataRx;             // POOL_PAGE block, 4 byte aligned (see mem_pool.c)
 BYTE* p;
+DWORD dwProgramAddr;       // next page address of the running program session
+BYTE ProgramOptions;       // BSL_PROG_xxx flags of the running program session
+BYTE BlockSeq;             // sequence number of the next data block (BSL_PROG_SEQUENCE)
+DWORD StageEnd;            // end of the staging area erased for a BSL_PROG_STAGE session
+int StageWriteError;       // page write to the staging area not started
+
+// BSL_PROG_WINDOW session: ring of received blocks waiting to be programmed
+#define WINDOW_MAX         16
+unsigned int* WindowBuf[WINDOW_MAX];   // [0] is DataRx, the rest from POOL_PAGE
+UINT WindowSize;           // buffers of the session, advertised to the host
+UINT WindowHead;           // oldest received block, programmed next
+UINT WindowCount;          // received blocks not yet programmed
+_Bool WindowWriting;       // head block is being written
+_Bool WindowEot;           // EOT received, close once all blocks are programmed
+BYTE RxSeq;                // sequence number of the next block to receive
+UINT RxPos;                // bytes of the current frame received so far
+UINT RxLen;                // length of the current frame
+BYTE RxType;               // block type of the current frame
+BYTE RxFrameSeq;           // sequence number of the current frame
+BYTE RxChksum;
+UINT RxIdle;               // draining the line: polls left until it counts as idle
+BYTE RxNak;                // reply code sent when the drain is over
 
 
 void SendByte(BYTE data)
 {
-	while(!((USIC0_CH0->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P0.14/P0.15
-	USIC0_CH0->IN[0] = data;
-
-	//while(!((USIC0_CH1->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P1.3/P1.2
-    //USIC0_CH1->IN[0] = data;
+	ASC_PutByte(data);
 }
 
 void SendWord(DWORD* BUF)
 {
 	for (int i=0;i<4;i++)
+		ASC_PutByte((BYTE)(*BUF>>8*i));
+}
+
+// Sends a 16 byte reply block: data type header, mode, 13 payload bytes
+// and the XOR checksum over all previous bytes
+void SendReply(BYTE mode, const BYTE* data)
+{
+	UINT i;
+	BYTE chksum = 0x01 ^ mode;
+
+	SendByte(0x01);
+	SendByte(mode);
+	for (i=0; i<HEADER_BLOCK_SIZE-3; i++)
 	{
-		while(!((USIC0_CH0->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P0.14/P0.15
-		USIC0_CH0->IN[0] = ((*BUF>>8*i) & 0xFF);
-		//while(!((USIC0_CH1->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P1.3/P1.2
-		//USIC0_CH1->IN[0] = ((*BUF>>8*i) & 0xFF);
+		chksum = chksum ^ data[i];
+		SendByte(data[i]);
 	}
+	SendByte(chksum);
 }
 
+// Reply of BSL_READ_FLASH: word address (MSB first), the word at it
+// (LSB first) and 5 unused bytes
 void Flash_ReadWord(DWORD dwAddr, DWORD* buf)
 {
-	signed int i;
-	unsigned char j;
-	unsigned char chksum = 0;
+	BYTE data[HEADER_BLOCK_SIZE-3] = {0};
+	int i;
+
 	buf = (DWORD*)dwAddr;
-	while(!((USIC0_CH0->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P0.14/P0.14
-	//while(!((USIC0_CH1->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P1.3/P1.2
-	chksum = chksum ^ 0x01;
-	USIC0_CH0->IN[0] = 0x01;	//Data type header for P0.14/P0.15
-	while(!((USIC0_CH0->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P0.14/P0.15
-	//USIC0_CH1->IN[0] = 0x01;	//Data type header for P1.3/P1.2
-	//while(!((USIC0_CH1->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P1.3/P1.2
-	chksum = chksum ^ 0x04;
-	USIC0_CH0->IN[0] = 0x04;	//Read Flash Mode for P0.14/P0.15
-//	USIC0_CH1->IN[0] = 0x04;	//Read Flash Mode for P1.3/P1.2
-	for (i=3;i>=0;i--)			//Send Read Address
+	for (i=0; i<4; i++)
 	{
-		while(!((USIC0_CH0->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P0.14/P0.15
-//		while(!((USIC0_CH1->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P1.3/P1.2
-		j = ((dwAddr>>8*i) & 0xFF);
-		chksum = chksum ^ j;
-		USIC0_CH0->IN[0] = j;					//for P0.14/P0.15
-//		USIC0_CH1->IN[0] = j;					//for P1.3/P1.2
-	}
-	for (i=0;i<4;i++)
-	{
-		while(!((USIC0_CH0->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P0.14/P0.15
-//		while(!((USIC0_CH1->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P1.3/P1.2
-		j = (((*buf)>>8*i) & 0xFF);
-		chksum = chksum ^ j;
-		USIC0_CH0->IN[0] = j;                 // send the 4 byte data for P0.14/P0.15
-//		USIC0_CH1->IN[0] = j;                 // send the 4 byte data for P1.3/P1.2
-	}
-	for (i=0;i<5;i++)
-	{
-		while(!((USIC0_CH0->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P0.14/P0.15
-//		while(!((USIC0_CH1->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty for P1.3/P1.2
-		chksum = chksum ^ 0x00;
-		USIC0_CH0->IN[0] = 0x00;                 // send the unused 5 bytes for P0.14/P0.15
-//		USIC0_CH1->IN[0] = 0x00;                 // send the unused 5 bytes for P1.3/P1.2
+		data[i] = (BYTE)(dwAddr >> 8*(3-i));
+		data[4+i] = (BYTE)(*buf >> 8*i);
 	}
-	while(!((USIC0_CH0->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty P0.14/P0.15
-	USIC0_CH0->IN[0] = chksum;                 // send the checksum
-//	while(!((USIC0_CH1->TRBSR & (0x01UL << 11)) >> 11) ) {}; //check if Tx FIFO is empty P1.3/P1.2
-//	USIC0_CH1->IN[0] = chksum;                 // send the checksum
-	return;
+	SendReply(BSL_READ_FLASH, data);
 }
 
 void EraseSector(DWORD dwSectorAddr, DWORD dwSize)
@@ -143,19 +146,8 @@ void EraseSector(DWORD dwSectorAddr, DWORD dwSize)
 		return;
 	}
 
-	while(dwSize>0)
-	{
-		volatile unsigned long* p=(volatile unsigned long*)(dwSectorAddr);
-		unsigned long dw=*p;
-//		if(0!=dw)
-		if(dw != 0xFFFFFFFF)					// check for programmed word
-			break;
-		dwSectorAddr+=4;
-		dwSize-=4;
-	}
-
 	//Sector is empty
-	if (dwSize == 0) {
+	if (XMC1000_FLASH_IsRangeBlank(dwSectorAddr, dwSize)) {
 		SendByte(BSL_ERASE_SUCCESS);
 		return;
 	}
@@ -168,24 +160,90 @@ void EraseSector(DWORD dwSectorAddr, DWORD dwSize)
 }
 
 
+// Reply to a data or EOT block: the code and, with BSL_PROG_SEQUENCE, the
+// sequence number of the block it refers to
+void SendBlockReply(BYTE code, BYTE seq)
+{
+	SendByte(code);
+	if (ProgramOptions & BSL_PROG_SEQUENCE)
+		SendByte(seq);
+}
+
+// Bad block with BSL_PROG_SEQUENCE: the rest of it is skipped so that the
+// host can send the expected block again on a block boundary
+void SendBlockNak(BYTE code)
+{
+	ASC_Drain();
+	SendBlockReply(code, BlockSeq);
+}
+
+// Page writes of a program session go to the internal flash or, with
+// BSL_PROG_STAGE, to the staging area of the SPI flash. Both run in the
+// background of WindowRx(); the page data is at p+2.
+void PageWriteStart(void)
+{
+#if SPI_FLASH
+	if (ProgramOptions & BSL_PROG_STAGE) {
+		//a page behind the erased area is not written
+		StageWriteError = (dwProgramAddr + PAGE_SIZE <= StageEnd) ?
+		                  SpiFlash_WriteStart(dwProgramAddr, p+2) : FLASHER_E_FAILED;
+		return;
+	}
+#endif
+	XMC1000_FLASH_WriteStart(dwProgramAddr, ProgramOptions & BSL_PROG_VERIFY);
+}
+
+int PageWritePoll(void)
+{
+#if SPI_FLASH
+	if (ProgramOptions & BSL_PROG_STAGE)
+		return SpiFlash_Poll();
+#endif
+	return XMC1000_FLASH_WritePoll();
+}
+
+int PageWriteFinish(void)
+{
+#if SPI_FLASH
+	if (ProgramOptions & BSL_PROG_STAGE) {
+		while (SpiFlash_Poll()) {}
+		return StageWriteError;
+	}
+#endif
+	return XMC1000_FLASH_WriteFinish();
+}
+
 _Bool ProgramFlashPage(DWORD dwPageAddr)
 {
+	int error;
 
 	// check if it is a valid page start address
 	if(dwPageAddr & XMC1000_FLASH_PAGE_START_MASK)
 	{
-		SendByte(BSL_ADDRESS_ERROR);
+		SendBlockReply(BSL_ADDRESS_ERROR, BlockSeq);
 		return 0;
 	}
 
-	if(0 != XMC1000_FLASH_ProgramPage(dwPageAddr))
+	if (ProgramOptions & BSL_PROG_LAZY_ERASE)
+		(void)XMC1000_FLASH_EraseFinish();	//a failed erase falls back to NvmProgVerify
+
+	if (ProgramOptions & BSL_PROG_STAGE) {
+		PageWriteStart();
+		error = PageWriteFinish();
+	}
+	else if (ProgramOptions & (BSL_PROG_ERASED | BSL_PROG_LAZY_ERASE))
+		error = XMC1000_FLASH_WritePage(dwPageAddr, ProgramOptions & BSL_PROG_VERIFY);
+	else
+		error = XMC1000_FLASH_ProgramPage(dwPageAddr);
+
+	if(0 != error)
 	{
-		SendByte(BSL_PROGRAM_ERROR);
+		SendBlockReply(BSL_PROGRAM_ERROR, BlockSeq);
 		return 0;
 	}
 	else
 	{
-		SendByte(BSL_SUCCESS); //send ackn here
+		SendBlockReply(BSL_SUCCESS, BlockSeq); //send ackn here
 		return 1;
 	}
 }
@@ -199,6 +257,631 @@ void ChangeBMI(unsigned short BMI)
 }
 
 
+void FlushTx(void)
+{
+	ASC_Flush();
+}
+
+
+DWORD HeaderDword(UINT pos)
+{
+	// addresses and sizes are sent MSB first, as in Flash_ReadWord
+	return ((DWORD)HeaderBlock[pos] << 24) | ((DWORD)HeaderBlock[pos+1] << 16) |
+	       ((DWORD)HeaderBlock[pos+2] << 8) | (DWORD)HeaderBlock[pos+3];
+}
+
+
+//*************************** Windowed program session **********************
+// Blocks are received byte by byte from the FIFO while the flash works on
+// older ones in the background, so the host can keep WindowSize blocks in
+// flight. A block is acknowledged once it is programmed; the ACK of block n
+// acknowledges all blocks up to n. Bad blocks are NAKed after the line went
+// idle and the host goes back to the named block.
+
+void WindowClose(void)
+{
+	UINT i;
+
+	(void)XMC1000_FLASH_EraseFinish();
+	for (i=1; i<WindowSize; i++)
+		PoolFree(WindowBuf[i]);
+	WindowSize = 0;
+}
+
+// Allocates the session buffers, returns their number
+UINT WindowOpen(void)
+{
+	WindowBuf[0] = DataRx;
+	for (WindowSize=1; WindowSize<WINDOW_MAX; WindowSize++)
+	{
+		WindowBuf[WindowSize] = PoolAlloc(PAGE_BUFFER_SIZE);
+		if (WindowBuf[WindowSize] == 0)
+			break;
+	}
+	WindowHead = 0;
+	WindowCount = 0;
+	WindowWriting = 0;
+	WindowEot = 0;
+	RxSeq = 0;
+	RxPos = 0;
+	RxIdle = 0;
+	return WindowSize;
+}
+
+void WindowNak(BYTE code)
+{
+	RxPos = 0;
+	RxNak = code;
+	RxIdle = ASC_IDLE_POLLS;
+}
+
+// Frame complete: accept it, drop a repeated one or NAK. The EOT block is
+// numbered like a data block, [1] is the number of blocks sent.
+void WindowFrame(BYTE chksum)
+{
+	BYTE ahead;
+
+	if (RxChksum != chksum) {
+		WindowNak(BSL_CHKSUM_ERROR);
+		return;
+	}
+
+	ahead = (BYTE)(RxFrameSeq - RxSeq);
+	if (ahead == 0) {
+		if (RxType == EOT_BLOCK)
+			WindowEot = 1;
+		else {
+			WindowCount++;
+			RxSeq++;
+		}
+	}
+	else if (ahead < 0x80) {
+		WindowNak(BSL_SEQUENCE_ERROR);			//a block in between was lost
+	}
+	//else: repeated by a go-back of the host, received before
+}
+
+void WindowRx(void)
+{
+	BYTE* frame = (BYTE*)WindowBuf[(WindowHead + WindowCount) % WindowSize] + 2;
+	BYTE b;
+
+	while (!ASC_RxEmpty()) {
+		b = ASC_GetByte();
+		if (RxIdle) {
+			RxIdle = ASC_IDLE_POLLS;
+			continue;
+		}
+
+		if (RxPos == 0) {
+			if (b == EOT_BLOCK)
+				RxLen = HEADER_BLOCK_SIZE;
+			else if ((b == DATA_BLOCK) && (WindowCount < WindowSize) && !WindowEot)
+				RxLen = DATA_BLOCK_SIZE;
+			else {
+				WindowNak((b == DATA_BLOCK) ? BSL_SEQUENCE_ERROR : BSL_BLOCK_TYPE_ERROR);
+				continue;
+			}
+			RxType = b;
+			RxChksum = 0;
+		}
+		else if (RxPos < RxLen-1) {
+			RxChksum ^= b;
+			if (RxPos == 1)
+				RxFrameSeq = b;
+		}
+
+		//only data blocks take a buffer, the head one may be in the flash write
+		if (RxType == DATA_BLOCK)
+			frame[RxPos] = b;
+		if (++RxPos == RxLen) {
+			RxPos = 0;
+			WindowFrame(b);
+			frame = (BYTE*)WindowBuf[(WindowHead + WindowCount) % WindowSize] + 2;
+		}
+	}
+
+	if (RxIdle && (--RxIdle == 0))
+		SendBlockReply(RxNak, RxSeq);
+}
+
+SESSION_STATE WindowSession(void)
+{
+	WindowRx();
+
+	if (WindowWriting) {
+		if (PageWritePoll())
+			return SESSION_WINDOW;
+		WindowWriting = 0;
+		if (PageWriteFinish() != FLASHER_SUCCESS) {
+			ASC_Drain();
+			SendBlockReply(BSL_PROGRAM_ERROR, BlockSeq);
+			WindowClose();
+			return SESSION_IDLE;
+		}
+		SendBlockReply(BSL_SUCCESS, BlockSeq);
+		BlockSeq++;
+		dwProgramAddr += PAGE_SIZE;
+		WindowHead = (WindowHead + 1) % WindowSize;
+		WindowCount--;
+	}
+
+	if (XMC1000_FLASH_ErasePoll())
+		return SESSION_WINDOW;
+
+	if (WindowCount) {
+		if (ProgramOptions & BSL_PROG_LAZY_ERASE) {
+			XMC1000_FLASH_EraseStart(dwProgramAddr);
+			if (XMC1000_FLASH_ErasePoll())
+				return SESSION_WINDOW;
+			(void)XMC1000_FLASH_EraseFinish();	//a failed erase falls back to NvmProgVerify
+		}
+		p = (BYTE*)WindowBuf[WindowHead] + 2;
+		PageWriteStart();
+		WindowWriting = 1;
+		return SESSION_WINDOW;
+	}
+
+	if (WindowEot && !RxIdle) {
+		SendBlockReply(BSL_SUCCESS, BlockSeq);		//program session closed
+		WindowClose();
+		return SESSION_IDLE;
+	}
+	return SESSION_WINDOW;
+}
+
+
+//*************************** Command handlers ****************************
+// Header layout (bytes 2..14, MSB first):
+//   BSL_PROGRAM_FLASH : [2..5] start page address, [6] BSL_PROG_xxx options,
+//                       data blocks follow, numbered from 0 with BSL_PROG_SEQUENCE;
+//                       with BSL_PROG_WINDOW the reply carries the window size;
+//                       with BSL_PROG_STAGE [2..5] is an SPI flash address and
+//                       [7..8] the number of pages, erased before the reply
+//   BSL_CHANGE_BMI    : [2..3] BMI value
+//   BSL_ERASE_FLASH   : [2..5] sector address, [6..9] size in bytes
+//   BSL_READ_FLASH    : [2..5] word address
+//   BSL_GET_STATS     : [2] BSL_STATS_xxx page, reply payload (MSB first):
+//                       SRAM: stack size, stack high-water, buffer count, buffer size
+//                       POOL: [3] POOL_xxx, block size, count, used, peak, failed
+//   BSL_FINALIZE      : [2..5] image address, [6..7] image size in pages,
+//                       [8..11] expected CRC-32, [12..13] BMI value, reply payload:
+//                       BSL_SUCCESS or BSL_VERIFY_ERROR, CRC-32 of the flash (MSB first)
+//   BSL_GET_INFO      : [2] BSL_INFO_xxx page, reply payload (MSB first):
+//                       LOADER: protocol version, command bitmap (bit n = mode n, 2 bytes),
+//                               BSL_PROG_xxx options supported, buffer count, buffer size,
+//                               window size of BSL_PROG_WINDOW, MCLK in Hz (4 bytes)
+//                       CHIP: page size, sector size, flash size (4 bytes),
+//                             SCU IDCHIP (4 bytes)
+//                       STAGE: SPI flash JEDEC ID (3 bytes), size (4 bytes, 0 = none)
+//   BSL_STAGE_COMMIT  : [2..5] SPI flash address, [6..9] flash address, [10..11] size
+//                       in pages, [12..14] low 24 bits of the CRC-32 of the staged
+//                       pages, reply payload: BSL_SUCCESS or error code, pages
+//                       programmed (2 bytes)
+//   BSL_SWD           : [2] BSL_SWD_xxx operation
+//                       CONNECT: [3] clock delay, reply payload: ACK, DPIDR (4 bytes)
+//                       TRANSFER: [3] number of records, see SwdTransfer()
+//                       READ_BLOCK, WRITE_BLOCK: [3..6] target address, [7] words,
+//                       see SwdBlock()
+
+SESSION_STATE CmdProgramFlash(void)
+{
+	dwProgramAddr = HeaderDword(2);
+	ProgramOptions = HeaderBlock[6];
+	BlockSeq = 0;
+	if(dwProgramAddr & XMC1000_FLASH_PAGE_START_MASK)
+	{
+		SendByte(BSL_ADDRESS_ERROR);
+		return SESSION_IDLE;
+	}
+	if (ProgramOptions & ~BSL_PROG_SUPPORTED)
+	{
+		SendByte(BSL_MODE_ERROR);
+		return SESSION_IDLE;
+	}
+	// a window session receives while the page is written, which only works
+	// for background writes: an erase and write of a page takes several ms,
+	// the receive FIFO covers ~350 us
+	if ((ProgramOptions & BSL_PROG_WINDOW) &&
+	    !(ProgramOptions & (BSL_PROG_ERASED | BSL_PROG_LAZY_ERASE | BSL_PROG_STAGE)))
+	{
+		SendByte(BSL_MODE_ERROR);
+		return SESSION_IDLE;
+	}
+#if SPI_FLASH
+	if (ProgramOptions & BSL_PROG_STAGE) {
+		// the staging area is erased now, the pages are programmed at line rate
+		ProgramOptions &= ~(BSL_PROG_ERASED | BSL_PROG_LAZY_ERASE);
+		StageEnd = dwProgramAddr + ((HeaderBlock[7] << 8) | HeaderBlock[8]) * PAGE_SIZE;
+		if (StageEnd > SpiFlash_Size()) {
+			SendByte(BSL_ADDRESS_ERROR);
+			return SESSION_IDLE;
+		}
+		if (SpiFlash_Erase(dwProgramAddr, StageEnd - dwProgramAddr) != FLASHER_SUCCESS) {
+			SendByte(BSL_ERASE_ERROR);
+			return SESSION_IDLE;
+		}
+	}
+#endif
+	SendByte(BSL_SUCCESS);				//ready for the first data block
+	if (ProgramOptions & BSL_PROG_WINDOW) {
+		ProgramOptions |= BSL_PROG_SEQUENCE;
+		SendByte((BYTE)WindowOpen());
+		return SESSION_WINDOW;
+	}
+	return SESSION_PROGRAM;
+}
+
+SESSION_STATE CmdChangeBMI(void)
+{
+	FlushTx();
+	ChangeBMI((WORD)((HeaderBlock[2] << 8) | HeaderBlock[3]));
+	// only reached if the ROM rejected the BMI value, otherwise the device resets
+	SendByte(BSL_BMI_ERROR);
+	return SESSION_IDLE;
+}
+
+SESSION_STATE CmdEraseFlash(void)
+{
+	EraseSector(HeaderDword(2), HeaderDword(6));
+	return SESSION_IDLE;
+}
+
+SESSION_STATE CmdReadFlash(void)
+{
+	DWORD dwAddr = HeaderDword(2);
+
+	if(dwAddr & 3)
+		SendByte(BSL_ADDRESS_ERROR);
+	else
+		Flash_ReadWord(dwAddr, 0);
+	return SESSION_IDLE;
+}
+
+SESSION_STATE CmdGetStats(void)
+{
+	BYTE data[HEADER_BLOCK_SIZE-3] = {0};
+	const POOL_STATS* stats;
+
+	switch (HeaderBlock[2]) {
+	case BSL_STATS_SRAM:
+		data[0] = (BYTE)(StackSize() >> 8);
+		data[1] = (BYTE)StackSize();
+		data[2] = (BYTE)(StackHighWater() >> 8);
+		data[3] = (BYTE)StackHighWater();
+		data[4] = (BYTE)(PoolStats(POOL_PAGE)->count >> 8);
+		data[5] = (BYTE)PoolStats(POOL_PAGE)->count;
+		data[6] = (BYTE)(PAGE_BUFFER_SIZE >> 8);
+		data[7] = (BYTE)PAGE_BUFFER_SIZE;
+		break;
+	case BSL_STATS_POOL:
+		stats = PoolStats(HeaderBlock[3]);
+		if (stats == 0) {
+			SendByte(BSL_MODE_ERROR);
+			return SESSION_IDLE;
+		}
+		data[0] = (BYTE)(stats->size >> 8);
+		data[1] = (BYTE)stats->size;
+		data[2] = (BYTE)(stats->count >> 8);
+		data[3] = (BYTE)stats->count;
+		data[4] = (BYTE)(stats->used >> 8);
+		data[5] = (BYTE)stats->used;
+		data[6] = (BYTE)(stats->peak >> 8);
+		data[7] = (BYTE)stats->peak;
+		data[8] = (BYTE)(stats->failed >> 8);
+		data[9] = (BYTE)stats->failed;
+		break;
+	default:
+		SendByte(BSL_MODE_ERROR);
+		return SESSION_IDLE;
+	}
+	SendReply(BSL_GET_STATS, data);
+	return SESSION_IDLE;
+}
+
+SESSION_STATE CmdFinalize(void)
+{
+	BYTE data[HEADER_BLOCK_SIZE-3] = {0};
+	DWORD dwAddr = HeaderDword(2);
+	DWORD dwSize = ((HeaderBlock[6] << 8) | HeaderBlock[7]) * PAGE_SIZE;
+	DWORD dwCrc;
+
+	if((dwSize == 0) || (dwAddr < XMC_FLASH_BASE) ||
+	   (dwAddr + dwSize > XMC_FLASH_BASE + XMC1000_FLASH_GetSize()))
+	{
+		SendByte(BSL_ADDRESS_ERROR);
+		return SESSION_IDLE;
+	}
+
+	dwCrc = XMC1000_FLASH_Crc32(dwAddr, dwSize);
+	data[0] = (dwCrc == HeaderDword(8)) ? BSL_SUCCESS : BSL_VERIFY_ERROR;
+	data[1] = (BYTE)(dwCrc >> 24);
+	data[2] = (BYTE)(dwCrc >> 16);
+	data[3] = (BYTE)(dwCrc >> 8);
+	data[4] = (BYTE)dwCrc;
+	SendReply(BSL_FINALIZE, data);
+	if (data[0] != BSL_SUCCESS)
+		return SESSION_IDLE;
+
+	// the reply has to be out before the BMI change resets the device
+	FlushTx();
+	ChangeBMI((WORD)((HeaderBlock[12] << 8) | HeaderBlock[13]));
+	SendByte(BSL_BMI_ERROR);
+	return SESSION_IDLE;
+}
+
+// Stores value MSB first in size bytes of a reply payload
+void PutReply(BYTE* data, DWORD value, UINT size)
+{
+	while (size--) {
+		data[size] = (BYTE)value;
+		value >>= 8;
+	}
+}
+
+extern const BSL_HANDLER CommandTable[BSL_MODE_COUNT];
+
+SESSION_STATE CmdGetInfo(void)
+{
+	BYTE data[HEADER_BLOCK_SIZE-3] = {0};
+	UINT buffers = PoolStats(POOL_PAGE)->count;
+	UINT commands = 0;
+	UINT i;
+
+	switch (HeaderBlock[2]) {
+	case BSL_INFO_LOADER:
+		for (i=0; i<BSL_MODE_COUNT; i++)
+			if (CommandTable[i] != 0)
+				commands |= 1U << i;
+		data[0] = BSL_PROTOCOL_VERSION;
+		PutReply(&data[1], commands, 2);
+		data[3] = BSL_PROG_SUPPORTED;
+		PutReply(&data[4], buffers, 2);
+		PutReply(&data[6], PAGE_BUFFER_SIZE, 2);
+		data[8] = (BYTE)((buffers < WINDOW_MAX) ? buffers : WINDOW_MAX);
+		SystemCoreClockUpdate();
+		PutReply(&data[9], SystemCoreClock, 4);
+		break;
+	case BSL_INFO_CHIP:
+		PutReply(&data[0], PAGE_SIZE, 2);
+		PutReply(&data[2], XMC_FLASH_BYTES_PER_SECTOR, 2);
+		PutReply(&data[4], XMC1000_FLASH_GetSize(), 4);
+		PutReply(&data[8], SCU_GENERAL->IDCHIP, 4);
+		break;
+#if SPI_FLASH
+	case BSL_INFO_STAGE:
+		PutReply(&data[0], SpiFlash_Id(), 3);
+		PutReply(&data[3], SpiFlash_Size(), 4);
+		break;
+#endif
+	default:
+		SendByte(BSL_MODE_ERROR);
+		return SESSION_IDLE;
+	}
+	SendReply(BSL_GET_INFO, data);
+	return SESSION_IDLE;
+}
+
+#if SPI_FLASH
+#define STAGE_CRC_MASK     0xFFFFFF    // CRC-32 bits in the BSL_STAGE_COMMIT header
+
+// Programs the flash from the staging area. The next page is read from the
+// SPI flash while the current one is written, both in the background.
+// The staged pages are checked against the CRC of the header before the
+// first page is written, and again as they are read back for programming.
+SESSION_STATE CmdStageCommit(void)
+{
+	BYTE data[HEADER_BLOCK_SIZE-3] = {0};
+	DWORD dwSrc = HeaderDword(2);
+	DWORD dwAddr = HeaderDword(6);
+	UINT pages = (HeaderBlock[10] << 8) | HeaderBlock[11];
+	DWORD dwSize = pages * PAGE_SIZE;
+	DWORD dwCrc = ((DWORD)HeaderBlock[12] << 16) | (HeaderBlock[13] << 8) | HeaderBlock[14];
+	DWORD dwStaged = 0;
+	unsigned int* buf[2];
+	UINT i;
+
+	if ((dwSize == 0) || (dwAddr & XMC1000_FLASH_PAGE_START_MASK) || (dwAddr < XMC_FLASH_BASE) ||
+	    (dwAddr + dwSize > XMC_FLASH_BASE + XMC1000_FLASH_GetSize()) || (dwSrc + dwSize > SpiFlash_Size()))
+	{
+		SendByte(BSL_ADDRESS_ERROR);
+		return SESSION_IDLE;
+	}
+
+	// nothing is programmed from a staging area that does not hold the image
+	for (i=0; i<pages; i++) {
+		SpiFlash_Read(dwSrc + i*PAGE_SIZE, (BYTE*)DataRx + 4, PAGE_SIZE);
+		dwStaged = XMC1000_FLASH_Crc32Add(dwStaged, (DWORD)DataRx + 4, PAGE_SIZE);
+	}
+	if ((dwStaged & STAGE_CRC_MASK) != dwCrc) {
+		data[0] = BSL_VERIFY_ERROR;
+		SendReply(BSL_STAGE_COMMIT, data);
+		return SESSION_IDLE;
+	}
+
+	// without a second buffer the pages are read and written in turn
+	buf[0] = DataRx;
+	buf[1] = PoolAlloc(PAGE_BUFFER_SIZE);
+
+	data[0] = BSL_SUCCESS;
+	dwStaged = 0;
+	SpiFlash_Read(dwSrc, (BYTE*)buf[0] + 4, PAGE_SIZE);
+	for (i=0; i<pages; i++) {
+		p = (BYTE*)buf[buf[1] ? (i & 1) : 0] + 2;
+		XMC1000_FLASH_WriteStart(dwAddr + i*PAGE_SIZE, 1);
+		if (buf[1] && (i+1 < pages))
+			SpiFlash_ReadStart(dwSrc + (i+1)*PAGE_SIZE, (BYTE*)buf[(i+1) & 1] + 4, PAGE_SIZE);
+		dwStaged = XMC1000_FLASH_Crc32Add(dwStaged, (DWORD)p + 2, PAGE_SIZE);
+		while (XMC1000_FLASH_WritePoll() | SpiFlash_Poll()) {}
+		if (XMC1000_FLASH_WriteFinish() != FLASHER_SUCCESS) {
+			data[0] = BSL_PROGRAM_ERROR;
+			break;
+		}
+		if (!buf[1] && (i+1 < pages))
+			SpiFlash_Read(dwSrc + (i+1)*PAGE_SIZE, (BYTE*)buf[0] + 4, PAGE_SIZE);
+	}
+	PoolFree(buf[1]);
+	// a page read back differently than in the check above
+	if ((data[0] == BSL_SUCCESS) && ((dwStaged & STAGE_CRC_MASK) != dwCrc))
+		data[0] = BSL_VERIFY_ERROR;
+
+	PutReply(&data[1], i, 2);
+	SendReply(BSL_STAGE_COMMIT, data);
+	return SESSION_IDLE;
+}
+#endif
+
+#if SWD_HOST
+// Sends size bytes and adds them to the XOR checksum of a reply stream
+void SendChecked(const BYTE* data, UINT size, BYTE* chksum)
+{
+	while (size--) {
+		*chksum ^= *data;
+		SendByte(*data++);
+	}
+}
+
+// BSL_SWD_TRANSFER: the header is followed by [3] records of 5 bytes, the
+// SWD_REQ_xxx request and the data to write (MSB first, ignored by reads),
+// and the XOR checksum of the records. The records are run in order until
+// one is not acknowledged with OK. Reply stream: BSL_SUCCESS or BSL_SWD_ERROR,
+// records done, ACK of the last one, the data of each read done (MSB first)
+// and the XOR checksum of all previous bytes.
+SESSION_STATE SwdTransfer(void)
+{
+	BYTE* rec = (BYTE*)DataRx;
+	UINT count = HeaderBlock[3];
+	BYTE head[3];
+	BYTE chksum = 0;
+	BYTE ack = SWD_ACK_OK;
+	DWORD value;
+	UINT done;
+	UINT i;
+
+	if ((count == 0) || (count > BSL_SWD_BATCH_MAX)) {
+		SendByte(BSL_MODE_ERROR);
+		return SESSION_IDLE;
+	}
+	for (i=0; i<count*5; i++) {
+		rec[i] = ASC_GetByte();
+		chksum ^= rec[i];
+	}
+	if (chksum != ASC_GetByte()) {
+		SendByte(BSL_CHKSUM_ERROR);
+		return SESSION_IDLE;
+	}
+
+	// read data replaces the record data
+	for (done=0; done<count; done++, rec+=5) {
+		value = ((DWORD)rec[1] << 24) | ((DWORD)rec[2] << 16) | ((DWORD)rec[3] << 8) | rec[4];
+		ack = SwdHost_Transfer(rec[0], &value);
+		if (ack != SWD_ACK_OK)
+			break;
+		PutReply(&rec[1], value, 4);
+	}
+
+	head[0] = (ack == SWD_ACK_OK) ? BSL_SUCCESS : BSL_SWD_ERROR;
+	head[1] = (BYTE)done;
+	head[2] = ack;
+	chksum = 0;
+	SendChecked(head, 3, &chksum);
+	for (rec=(BYTE*)DataRx, i=0; i<done; i++, rec+=5)
+		if (rec[0] & SWD_REQ_RnW)
+			SendChecked(&rec[1], 4, &chksum);
+	SendByte(chksum);
+	return SESSION_IDLE;
+}
+
+// BSL_SWD_READ_BLOCK, BSL_SWD_WRITE_BLOCK: target memory through DRW with TAR
+// auto increment, the AP and CSW are set up by the host with BSL_SWD_TRANSFER.
+// Write data follows the header in memory order with its XOR checksum. Reply
+// stream as for BSL_SWD_TRANSFER, with the number of words read (0 after an
+// error) in place of the records done and the words in memory order.
+SESSION_STATE SwdBlock(void)
+{
+	BYTE* buf = (BYTE*)DataRx;
+	DWORD dwAddr = HeaderDword(3);
+	UINT count = HeaderBlock[7];
+	BYTE head[3];
+	BYTE chksum = 0;
+	BYTE ack;
+	UINT i;
+
+	if ((count == 0) || (count > BSL_SWD_BLOCK_MAX) || (dwAddr & 3)) {
+		SendByte(BSL_ADDRESS_ERROR);
+		return SESSION_IDLE;
+	}
+
+	if (HeaderBlock[2] == BSL_SWD_WRITE_BLOCK) {
+		for (i=0; i<count*4; i++) {
+			buf[i] = ASC_GetByte();
+			chksum ^= buf[i];
+		}
+		if (chksum != ASC_GetByte()) {
+			SendByte(BSL_CHKSUM_ERROR);
+			return SESSION_IDLE;
+		}
+		ack = SwdHost_WriteBlock(dwAddr, (DWORD*)buf, count);
+		count = 0;
+	}
+	else
+		ack = SwdHost_ReadBlock(dwAddr, (DWORD*)buf, count);
+
+	if (ack != SWD_ACK_OK)
+		count = 0;
+	head[0] = (ack == SWD_ACK_OK) ? BSL_SUCCESS : BSL_SWD_ERROR;
+	head[1] = (BYTE)count;
+	head[2] = ack;
+	chksum = 0;
+	SendChecked(head, 3, &chksum);
+	SendChecked(buf, count*4, &chksum);
+	SendByte(chksum);
+	return SESSION_IDLE;
+}
+
+SESSION_STATE CmdSwd(void)
+{
+	BYTE data[HEADER_BLOCK_SIZE-3] = {0};
+	DWORD idcode = 0;
+
+	switch (HeaderBlock[2]) {
+	case BSL_SWD_CONNECT:
+		SwdHost_SetDelay(HeaderBlock[3]);
+		data[0] = SwdHost_Connect(&idcode);
+		PutReply(&data[1], idcode, 4);
+		SendReply(BSL_SWD, data);
+		return SESSION_IDLE;
+	case BSL_SWD_TRANSFER:
+		return SwdTransfer();
+	case BSL_SWD_READ_BLOCK:
+	case BSL_SWD_WRITE_BLOCK:
+		return SwdBlock();
+	default:
+		SendByte(BSL_MODE_ERROR);
+		return SESSION_IDLE;
+	}
+}
+#endif
+
+// indexed by HeaderBlock[1], empty slots are rejected by WaitForHeader()
+const BSL_HANDLER CommandTable[BSL_MODE_COUNT] =
+{
+	[BSL_PROGRAM_FLASH] = CmdProgramFlash,
+	[BSL_CHANGE_BMI]    = CmdChangeBMI,
+	[BSL_ERASE_FLASH]   = CmdEraseFlash,
+	[BSL_READ_FLASH]    = CmdReadFlash,
+	[BSL_GET_STATS]     = CmdGetStats,
+	[BSL_FINALIZE]      = CmdFinalize,
+	[BSL_GET_INFO]      = CmdGetInfo,
+#if SPI_FLASH
+	[BSL_STAGE_COMMIT]  = CmdStageCommit,
+#endif
+#if SWD_HOST
+	[BSL_SWD]           = CmdSwd,
+#endif
+};
+
+
 _Bool WaitForDataBlock(void)
 {
 	UINT i;
@@ -207,28 +890,23 @@ _Bool WaitForDataBlock(void)
 	p = p+2;       //set Data pointer to Byte 0 of Data Block
 
 	//First byte
-	while(((USIC0_CH0->TRBSR & (0x01UL << 3) ) >> 3)){};  //check RXempty flag for P0.14/P0.15
-	*p = (USIC0_CH0->OUTR & 0xFF);
-//	while(((USIC0_CH1->TRBSR & (0x01UL << 3) ) >> 3)){};  //check RXempty flag for P1.3/P1.2
-//	*p = (USIC0_CH1->OUTR & 0xFF);
+	*p = ASC_GetByte();
 
 	//check for EOT block and return if found
 	if (*p == EOT_BLOCK) {
 		//read remaining 15 bytes of EOT block from interface
 		for (i=1; i<HEADER_BLOCK_SIZE-1; i++)
 		{
-		    while(((USIC0_CH0->TRBSR & (0x01UL << 3) ) >> 3)){};   //check RXempty flag for P0.14/P0.15
-           chksum = chksum ^ (USIC0_CH0->OUTR & 0xFF);
-//		    while(((USIC0_CH1->TRBSR & (0x01UL << 3) ) >> 3)){};   //check RXempty flag for P1.3/P1.2
-//           chksum = chksum ^ (USIC0_CH1->OUTR & 0xFF);
+			chksum = chksum ^ ASC_GetByte();
 		}
 
-		while(((USIC0_CH0->TRBSR & (0x01UL << 3) ) >> 3)){};		//for P0.14/P0.15
 		//compare checksums
-		if (chksum != (USIC0_CH0->OUTR & 0xFF)) {					//for P0.14/P0.15
-//		while(((USIC0_CH1->TRBSR & (0x01UL << 3) ) >> 3)){};		//for P1.3/P1.2
-//		//compare checksums
-//		if (chksum != (USIC0_CH1->OUTR & 0xFF)) {					//for P1.3/P1.2
+		if (chksum != ASC_GetByte()) {
+			if (ProgramOptions & BSL_PROG_SEQUENCE) {
+				SendBlockNak(BSL_CHKSUM_ERROR);
+				*p = DATA_BLOCK; //session goes on, the host repeats the EOT block
+				return 0;
+			}
 			SendByte(BSL_CHKSUM_ERROR);
 			*p = 0xFF; //make block type invalid
 			return 0;
@@ -238,17 +916,24 @@ _Bool WaitForDataBlock(void)
 	}
 
 	if (*p != DATA_BLOCK) {
+		if (ProgramOptions & BSL_PROG_SEQUENCE) {
+			SendBlockNak(BSL_BLOCK_TYPE_ERROR);		//lost sync, not a lost session
+			*p = DATA_BLOCK;
+			return 0;
+		}
 		SendByte(BSL_BLOCK_TYPE_ERROR);
 		return 0;
 	}
 
+	//the page is coming: erase its sector while the data is received
+	if (ProgramOptions & BSL_PROG_LAZY_ERASE)
+		XMC1000_FLASH_EraseStart(dwProgramAddr);
+
 	//remaining 263 bytes
 	for (i=1; i<PAGE_SIZE+8; i++)
 	{
-		while(((USIC0_CH0->TRBSR & (0x01UL << 3) ) >> 3)){};		//for P0.14/P0.15
-       *(p+i) = (USIC0_CH0->OUTR & 0xFF);							//for P0.14/P0.15
-//		while(((USIC0_CH1->TRBSR & (0x01UL << 3) ) >> 3)){};		//for P1.3/P1.2
- //      *(p+i) = (USIC0_CH1->OUTR & 0xFF);							//for P1.3/P1.2
+		while(ASC_RxEmpty()) { XMC1000_FLASH_ErasePoll(); };
+		*(p+i) = ASC_GetByte();
 	}
 
 
@@ -256,7 +941,18 @@ _Bool WaitForDataBlock(void)
 	    chksum = chksum ^ *(p+i);
 
 	if (chksum != *(p+PAGE_SIZE+7)) {
-		SendByte(BSL_CHKSUM_ERROR);
+		if (ProgramOptions & BSL_PROG_SEQUENCE)
+			SendBlockNak(BSL_CHKSUM_ERROR);
+		else
+			SendByte(BSL_CHKSUM_ERROR);
+		return 0;
+	}
+
+	if ((ProgramOptions & BSL_PROG_SEQUENCE) && (p[1] != BlockSeq)) {
+		if (p[1] == (BYTE)(BlockSeq-1))
+			SendBlockReply(BSL_SUCCESS, p[1]);		//repeated after a lost ACK, already programmed
+		else
+			SendBlockNak(BSL_SEQUENCE_ERROR);
 		return 0;
 	}
 	return 1;
@@ -271,24 +967,15 @@ _Bool WaitForHeader(void)
 	BYTE chksum = 0;
 
 	for (i=0; i<HEADER_BLOCK_SIZE; i++)
-	{
-
-		while(((USIC0_CH0->TRBSR & (0x01UL << 3) ) >> 3))	{};	//receive the header information for P0.14/P0.15
-       HeaderBlock[i] = (USIC0_CH0->OUTR & 0xFF);
-//while(((USIC0_CH1->TRBSR & (0x01UL << 3) ) >> 3))	{};	//receive the header information for P1.3/P1.2
-       //HeaderBlock[i] = (USIC0_CH1->OUTR & 0xFF);
-
-	}
+		HeaderBlock[i] = ASC_GetByte();
 
 	if (HeaderBlock[0] != HEADER_BLOCK) {
 		SendByte(BSL_BLOCK_TYPE_ERROR);
 		return 0;
 	}
 
-	if ((HeaderBlock[1]!=BSL_PROGRAM_FLASH) &&
-		(HeaderBlock[1]!=BSL_ERASE_FLASH) &&
-		(HeaderBlock[1]!=BSL_READ_FLASH) &&
-		(HeaderBlock[1]!=BSL_CHANGE_BMI)) {
+	if ((HeaderBlock[1] >= BSL_MODE_COUNT) ||
+		(CommandTable[HeaderBlock[1]] == 0)) {
 		SendByte(BSL_MODE_ERROR);
 		return 0;
 	}
@@ -305,11 +992,60 @@ _Bool WaitForHeader(void)
 }
 
 
+SESSION_STATE ProgramSession(void)
+{
+	if (WaitForDataBlock()) {
+		if (ProgramFlashPage(dwProgramAddr)) {
+			dwProgramAddr += PAGE_SIZE;
+			BlockSeq++;
+		}
+		return SESSION_PROGRAM;
+	}
+
+	// checksum or sequence error: host repeats the block; wrong block type: session
+	// is lost (kept with BSL_PROG_SEQUENCE)
+	if (*p == DATA_BLOCK)
+		return SESSION_PROGRAM;
+
+	// a lazy erase started for a block that never got programmed must not
+	// leave NVMPROG in erase mode for the next command
+	(void)XMC1000_FLASH_EraseFinish();
+	if (*p == EOT_BLOCK)
+		SendBlockReply(BSL_SUCCESS, BlockSeq);			//program session closed
+	return SESSION_IDLE;
+}
+
+
 int main(void)
 {
+	SESSION_STATE state = SESSION_IDLE;
+
+	StackPaint();
+	PoolInit();
+	DataRx = PoolAlloc(PAGE_BUFFER_SIZE);
+
 	ASC_Init();
-	ChangeBMI(0xF8C3);
+#if SPI_FLASH
+	(void)SpiFlash_Init();				//no flash: BSL_INFO_STAGE reports size 0
+#endif
+#if SWD_HOST
+	SwdHost_Init();
+#endif
+	SendByte(BSL_SUCCESS);				//loader is up and waits for a header
+
 	for (;;) {
-		SendByte(BSL_SUCCESS);
+		switch (state) {
+		case SESSION_PROGRAM:
+			state = ProgramSession();
+			break;
+		case SESSION_WINDOW:
+			state = WindowSession();
+			break;
+		case SESSION_IDLE:
+		default:
+			if (WaitForHeader())
+				state = CommandTable[HeaderBlock[1]]();
+			break;
+		}
 	}
 }
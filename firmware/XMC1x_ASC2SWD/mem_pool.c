@@ -0,0 +1,172 @@
+/**************************************************************************
+ * @file     mem_pool.c
+ * @brief    Fixed-block pool allocator for the XMC1000 Bootloader
+ *
+ *           Heap_Bank1 (everything between the end of .bss and the end of
+ *           SRAM_1) is split at PoolInit() into as many page buffers as
+ *           fit. Free blocks are kept in a singly linked list per pool and
+ *           allocated ones are marked in a bitmap, so PoolAlloc() and
+ *           PoolFree() take constant time and freed blocks never fragment.
+ *           PoolFree() ignores pointers that are not the start of a block
+ *           and blocks that are not allocated.
+ *
+ *           _sbrk() is overridden to refuse all requests: malloc() would
+ *           otherwise hand out the same SRAM as the pools.
+ *
+ **************************************************************************/
+
+#include <XMC1300.h>
+#include <errno.h>
+#include "mem_pool.h"
+#include "sram_budget.h"
+
+// ----------------------------------------------------------------------------
+//   linker symbols
+// ----------------------------------------------------------------------------
+
+extern unsigned int Heap_Bank1_Start;
+extern unsigned int Heap_Bank1_Size;
+
+// ----------------------------------------------------------------------------
+//   local defines
+// ----------------------------------------------------------------------------
+
+// SRAM_1 of linker_script.ld in page buffers, bounds the in-use bitmap
+#define POOL_SRAM_SIZE         0x3E00
+#define POOL_MAX_BLOCKS        (POOL_SRAM_SIZE / PAGE_BUFFER_SIZE)
+#define POOL_MAP_WORDS         ((POOL_MAX_BLOCKS + 31) / 32)
+
+// ----------------------------------------------------------------------------
+//   local types and data
+// ----------------------------------------------------------------------------
+
+typedef struct tagPoolBlock
+{
+	struct tagPoolBlock* next;
+} POOL_BLOCK;
+
+typedef struct tagPool
+{
+	POOL_BLOCK* free;       // first free block, NULL if empty
+	BYTE* base;             // first block
+	BYTE* end;              // behind the last block
+	DWORD in_use[POOL_MAP_WORDS];   // bit n set while block n is allocated
+	POOL_STATS stats;
+} POOL;
+
+static POOL Pool[POOL_COUNT];
+
+// ----------------------------------------------------------------------------
+//   local functions
+// ----------------------------------------------------------------------------
+
+// Carves count blocks of size bytes at base, returns the end of the pool
+static BYTE* PoolCreate(POOL* pool, BYTE* base, UINT size, UINT count)
+{
+	UINT i;
+
+	pool->base = base;
+	pool->end = base + size * count;
+	pool->free = 0;
+	pool->stats.size = size;
+	pool->stats.count = count;
+	pool->stats.used = 0;
+	pool->stats.peak = 0;
+	pool->stats.failed = 0;
+	for (i=0; i<POOL_MAP_WORDS; i++)
+		pool->in_use[i] = 0;
+
+	// link from the top so that the lowest block is handed out first
+	for (i=count; i>0; i--)
+	{
+		POOL_BLOCK* block = (POOL_BLOCK*) (base + (i-1) * size);
+		block->next = pool->free;
+		pool->free = block;
+	}
+	return pool->end;
+}
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+void PoolInit(void)
+{
+	BYTE* base = (BYTE*) (((DWORD)&Heap_Bank1_Start + 3) & ~3UL);
+	BYTE* end = (BYTE*)&Heap_Bank1_Start + (DWORD)&Heap_Bank1_Size;
+	UINT count = (UINT)((DWORD)(end - base) / PAGE_BUFFER_SIZE);
+
+	if (count > POOL_MAX_BLOCKS)
+		count = POOL_MAX_BLOCKS;
+	PoolCreate(&Pool[POOL_PAGE], base, PAGE_BUFFER_SIZE, count);
+}
+
+// Smallest block class that holds size bytes, NULL if none is free
+void* PoolAlloc(UINT size)
+{
+	POOL* pool;
+	POOL_BLOCK* block;
+	UINT i, n;
+
+	for (i=POOL_COUNT; i>0; i--)
+	{
+		pool = &Pool[i-1];
+		if (size <= pool->stats.size)
+			break;
+	}
+	if (i == 0)
+		return 0;
+
+	block = pool->free;
+	if (block == 0)
+	{
+		pool->stats.failed++;
+		return 0;
+	}
+	pool->free = block->next;
+	n = (UINT)((DWORD)((BYTE*)block - pool->base) / pool->stats.size);
+	pool->in_use[n / 32] |= 1UL << (n % 32);
+	if (++pool->stats.used > pool->stats.peak)
+		pool->stats.peak = pool->stats.used;
+	return block;
+}
+
+void PoolFree(void* block)
+{
+	DWORD offset, bit;
+	UINT i, n;
+
+	if (block == 0)
+		return;
+
+	for (i=0; i<POOL_COUNT; i++)
+	{
+		POOL* pool = &Pool[i];
+		if (((BYTE*)block >= pool->base) && ((BYTE*)block < pool->end))
+		{
+			offset = (DWORD)((BYTE*)block - pool->base);
+			n = (UINT)(offset / pool->stats.size);
+			bit = 1UL << (n % 32);
+			if ((offset != n * pool->stats.size) || !(pool->in_use[n / 32] & bit))
+				return;		// not a block start, or double free
+			pool->in_use[n / 32] &= ~bit;
+			((POOL_BLOCK*)block)->next = pool->free;
+			pool->free = (POOL_BLOCK*)block;
+			pool->stats.used--;
+			return;
+		}
+	}
+}
+
+const POOL_STATS* PoolStats(UINT pool)
+{
+	return (pool < POOL_COUNT) ? &Pool[pool].stats : 0;
+}
+
+// Heap_Bank1 belongs to the pools, no bump heap behind malloc()
+void *_sbrk(int RequestedSize)
+{
+	(void)RequestedSize;
+	errno = ENOMEM;
+	return (void*)-1;
+}
@@ -0,0 +1,43 @@
+/**************************************************************************
+ * @file     mem_pool.h
+ * @brief    Fixed-block pool allocator for the XMC1000 Bootloader
+ *
+ **************************************************************************/
+
+#ifndef __MEM_POOL_H__
+#define __MEM_POOL_H__
+
+#include "flasher.h"
+
+// ----------------------------------------------------------------------------
+//   public defines
+// ----------------------------------------------------------------------------
+
+// block classes, smallest index = largest block
+#define POOL_PAGE              0     // PAGE_BUFFER_SIZE blocks, all SRAM left over
+#define POOL_COUNT             1
+
+// ----------------------------------------------------------------------------
+//   public types
+// ----------------------------------------------------------------------------
+
+// Occupancy counters of one pool, reported by BSL_GET_STATS (BSL_STATS_POOL)
+typedef struct tagPoolStats
+{
+	UINT size;              // block size in bytes
+	UINT count;             // blocks in the pool
+	UINT used;              // blocks allocated now
+	UINT peak;              // most blocks allocated at the same time
+	UINT failed;            // allocations refused because the pool was empty
+} POOL_STATS;
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+void PoolInit(void);
+void* PoolAlloc(UINT size);
+void PoolFree(void* block);
+const POOL_STATS* PoolStats(UINT pool);
+
+#endif  // __MEM_POOL_H__
@@ -0,0 +1,275 @@
+/**************************************************************************
+ * @file     spi_flash.c
+ * @brief    SPI NOR flash staging area of the XMC1000 Bootloader
+ *
+ *           With SPI_FLASH=1 the USIC0 channel that the UART does not use
+ *           drives a standard SPI NOR flash (JEDEC commands, 3 byte
+ *           addresses, mode 0). BSL_PROG_STAGE writes received pages into
+ *           it at line rate, BSL_STAGE_COMMIT later programs the internal
+ *           flash from it without the UART in the loop.
+ *
+ *           Page program and read run in the background: SpiFlash_Poll()
+ *           moves the FIFO transfer on and watches the busy flag, so the
+ *           UART receive FIFO is served in between.
+ *
+ **************************************************************************/
+
+#include <XMC1300.h>
+#include "xmc_spi.h"
+#include "xmc_gpio.h"
+#include "asc_transport.h"
+#include "spi_flash.h"
+
+#if SPI_FLASH
+
+// ----------------------------------------------------------------------------
+//   channel and pins
+// ----------------------------------------------------------------------------
+
+// pins as port, pin, mode for SpiPin()
+#if ASC_CHANNEL == 0
+#define SPI_CH                 XMC_SPI0_CH1
+#define SPI_DX0                USIC0_C1_DX0_P0_6
+#define SPI_MISO               P0_6, XMC_GPIO_MODE_INPUT_TRISTATE
+#define SPI_MOSI               P0_7, (XMC_GPIO_MODE_t)P0_7_AF_U0C1_DOUT0
+#define SPI_SCLK               P0_8, (XMC_GPIO_MODE_t)P0_8_AF_U0C1_SCLKOUT
+#define SPI_CS                 P0_9, (XMC_GPIO_MODE_t)P0_9_AF_U0C1_SELO0
+#elif ASC_CHANNEL == 1
+#define SPI_CH                 XMC_SPI0_CH0
+#define SPI_DX0                USIC0_C0_DX0_P1_1
+#define SPI_MISO               P1_1, XMC_GPIO_MODE_INPUT_TRISTATE
+#define SPI_MOSI               P1_0, (XMC_GPIO_MODE_t)P1_0_AF_U0C0_DOUT0
+#define SPI_SCLK               P0_7, (XMC_GPIO_MODE_t)P0_7_AF_U0C0_SCLKOUT
+#define SPI_CS                 P0_9, (XMC_GPIO_MODE_t)P0_9_AF_U0C0_SELO0
+#else
+#error "SPI_FLASH needs a fixed ASC_CHANNEL, the SPI flash takes the other USIC0 channel"
+#endif
+
+// FIFO entries shared with the UART (TX 0..1, RX 32..63): the receive FIFO
+// bounds the words in flight, the transmit FIFO only has to stay ahead
+#define SPI_TX_DPTR            8
+#define SPI_TX_SIZE            XMC_USIC_CH_FIFO_SIZE_8WORDS
+#define SPI_RX_DPTR            16
+#define SPI_RX_SIZE            XMC_USIC_CH_FIFO_SIZE_16WORDS
+
+// ----------------------------------------------------------------------------
+//   local defines
+// ----------------------------------------------------------------------------
+
+#define CMD_WRITE_ENABLE       0x06
+#define CMD_READ_STATUS        0x05
+#define CMD_READ               0x03
+#define CMD_PAGE_PROGRAM       0x02
+#define CMD_SECTOR_ERASE       0x20    // SPI_FLASH_SECTOR_SIZE
+#define CMD_BLOCK_ERASE        0xD8    // SPI_FLASH_BLOCK_SIZE
+#define CMD_READ_ID            0x9F
+
+#define STATUS_WIP             0x01    // program or erase running
+#define STATUS_WEL             0x02    // write enable latch
+
+// background operation
+#define SPI_IDLE               0
+#define SPI_DATA               1       // data phase of a read or page program
+#define SPI_PROGRAM            2       // deselected, page program running
+
+// ----------------------------------------------------------------------------
+//   local data
+// ----------------------------------------------------------------------------
+
+static XMC_SPI_CH_TRANSFER_t Transfer;
+static BYTE State;
+static BYTE Programming;     // data phase belongs to a page program
+static DWORD FlashId;        // JEDEC manufacturer, type, capacity
+static DWORD FlashSize;      // 0 if no flash answered
+
+// ----------------------------------------------------------------------------
+//   local functions
+// ----------------------------------------------------------------------------
+
+static void SpiPin(XMC_GPIO_PORT_t* port, uint8_t pin, XMC_GPIO_MODE_t mode)
+{
+	XMC_GPIO_CONFIG_t config;
+
+	config.mode = mode;
+	config.input_hysteresis = XMC_GPIO_INPUT_HYSTERESIS_STANDARD;
+	config.output_level = XMC_GPIO_OUTPUT_LEVEL_HIGH;
+	XMC_GPIO_Init(port, pin, &config);
+}
+
+// Selects the flash and sends cmd, followed by a 24 bit address if addr_len is 3
+static void SpiBegin(BYTE cmd, DWORD addr, UINT addr_len)
+{
+	BYTE buf[4];
+
+	buf[0] = cmd;
+	buf[1] = (BYTE)(addr >> 16);
+	buf[2] = (BYTE)(addr >> 8);
+	buf[3] = (BYTE)addr;
+	XMC_SPI_CH_EnableSlaveSelect(SPI_CH, XMC_SPI_CH_SLAVE_SELECT_0);
+	XMC_SPI_CH_Transfer(SPI_CH, buf, 0, 1 + addr_len);
+}
+
+static void SpiEnd(void)
+{
+	XMC_SPI_CH_DisableSlaveSelect(SPI_CH);
+}
+
+static BYTE SpiStatus(void)
+{
+	BYTE status;
+
+	SpiBegin(CMD_READ_STATUS, 0, 0);
+	XMC_SPI_CH_Transfer(SPI_CH, 0, &status, 1);
+	SpiEnd();
+	return status;
+}
+
+// 0 if the write enable latch did not set (no flash, or write protected)
+static int SpiWriteEnable(void)
+{
+	SpiBegin(CMD_WRITE_ENABLE, 0, 0);
+	SpiEnd();
+	return (SpiStatus() & STATUS_WEL) != 0;
+}
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+// Sets up the channel and pins and reads the JEDEC ID. FLASHER_E_FAILED if
+// no flash answered, SpiFlash_Size() is 0 then.
+int SpiFlash_Init(void)
+{
+	const XMC_SPI_CH_CONFIG_t config =
+	{
+		.baudrate = SPI_FLASH_BAUD,
+		.bus_mode = XMC_SPI_CH_BUS_MODE_MASTER,
+		.selo_inversion = XMC_SPI_CH_SLAVE_SEL_INV_TO_MSLS,
+		.parity_mode = XMC_USIC_CH_PARITY_MODE_NONE
+	};
+	BYTE id[3];
+
+	XMC_SPI_CH_Init(SPI_CH, &config);
+	XMC_SPI_CH_SetWordLength(SPI_CH, 8);
+	XMC_SPI_CH_SetBitOrderMsbFirst(SPI_CH);
+	XMC_SPI_CH_ConfigureShiftClockOutput(SPI_CH, XMC_SPI_CH_BRG_SHIFT_CLOCK_PASSIVE_LEVEL_0_DELAY_ENABLED,
+	                                     XMC_SPI_CH_BRG_SHIFT_CLOCK_OUTPUT_SCLK);
+	XMC_SPI_CH_SetInputSource(SPI_CH, XMC_SPI_CH_INPUT_DIN0, SPI_DX0);
+	XMC_USIC_CH_TXFIFO_Configure(SPI_CH, SPI_TX_DPTR, SPI_TX_SIZE, 1);
+	XMC_USIC_CH_RXFIFO_Configure(SPI_CH, SPI_RX_DPTR, SPI_RX_SIZE, 0);
+	XMC_SPI_CH_Start(SPI_CH);
+
+	SpiPin(SPI_MISO);
+	SpiPin(SPI_MOSI);
+	SpiPin(SPI_SCLK);
+	SpiPin(SPI_CS);
+
+	SpiBegin(CMD_READ_ID, 0, 0);
+	XMC_SPI_CH_Transfer(SPI_CH, 0, id, 3);
+	SpiEnd();
+	FlashId = ((DWORD)id[0] << 16) | ((DWORD)id[1] << 8) | id[2];
+
+	// the capacity byte is log2 of the size in bytes
+	FlashSize = 0;
+	if ((id[0] != 0x00) && (id[0] != 0xFF) && (id[2] >= 16) && (id[2] < 32))
+		FlashSize = (id[2] < 24) ? (1UL << id[2]) : SPI_FLASH_MAX_SIZE;
+	State = SPI_IDLE;
+	return FlashSize ? FLASHER_SUCCESS : FLASHER_E_FAILED;
+}
+
+DWORD SpiFlash_Id(void)
+{
+	return FlashId;
+}
+
+DWORD SpiFlash_Size(void)
+{
+	return FlashSize;
+}
+
+// Erases the sectors that hold Addr..Addr+Size-1 (blocking), 64 KB at a time
+// where the range allows it
+int SpiFlash_Erase(DWORD Addr, DWORD Size)
+{
+	DWORD end = Addr + Size;
+	DWORD step;
+	BYTE cmd;
+
+	if ((end > FlashSize) || (end < Addr))
+		return FLASHER_E_FAILED;
+
+	Addr &= ~(DWORD)(SPI_FLASH_SECTOR_SIZE - 1);
+	while (Addr < end)
+	{
+		if (!(Addr & (SPI_FLASH_BLOCK_SIZE - 1)) && (end - Addr >= SPI_FLASH_BLOCK_SIZE)) {
+			cmd = CMD_BLOCK_ERASE;
+			step = SPI_FLASH_BLOCK_SIZE;
+		}
+		else {
+			cmd = CMD_SECTOR_ERASE;
+			step = SPI_FLASH_SECTOR_SIZE;
+		}
+		if (!SpiWriteEnable())
+			return FLASHER_E_FAILED;
+		SpiBegin(cmd, Addr, 3);
+		SpiEnd();
+		while (SpiStatus() & STATUS_WIP) {}
+		Addr += step;
+	}
+	return FLASHER_SUCCESS;
+}
+
+// Starts a background read of Size bytes at Addr into Buf
+void SpiFlash_ReadStart(DWORD Addr, BYTE* Buf, UINT Size)
+{
+	SpiBegin(CMD_READ, Addr, 3);
+	XMC_SPI_CH_StartTransfer(&Transfer, SPI_CH, 0, Buf, Size);
+	Programming = 0;
+	State = SPI_DATA;
+}
+
+void SpiFlash_Read(DWORD Addr, BYTE* Buf, UINT Size)
+{
+	SpiFlash_ReadStart(Addr, Buf, Size);
+	while (SpiFlash_Poll()) {}
+}
+
+// Starts a background page program of PAGE_SIZE bytes at the page address
+// Addr, the sector must have been erased by SpiFlash_Erase(). FLASHER_E_FAILED
+// without starting if the write enable latch did not set.
+int SpiFlash_WriteStart(DWORD Addr, const BYTE* Data)
+{
+	if (!SpiWriteEnable())
+		return FLASHER_E_FAILED;
+	SpiBegin(CMD_PAGE_PROGRAM, Addr, 3);
+	XMC_SPI_CH_StartTransfer(&Transfer, SPI_CH, Data, 0, PAGE_SIZE);
+	Programming = 1;
+	State = SPI_DATA;
+	return FLASHER_SUCCESS;
+}
+
+// Cheap enough to be called while waiting for a received byte. Returns 1
+// as long as the background read or page program is running.
+int SpiFlash_Poll(void)
+{
+	switch (State)
+	{
+	case SPI_DATA:
+		XMC_SPI_CH_TransferHandler(&Transfer);
+		if (!XMC_SPI_CH_IsTransferDone(&Transfer))
+			return 1;
+		// the flash starts the page program when it is deselected
+		SpiEnd();
+		State = Programming ? SPI_PROGRAM : SPI_IDLE;
+		return Programming;
+	case SPI_PROGRAM:
+		if (SpiStatus() & STATUS_WIP)
+			return 1;
+		State = SPI_IDLE;
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+#endif  // SPI_FLASH
@@ -0,0 +1,38 @@
+/**************************************************************************
+ * @file     spi_flash.h
+ * @brief    SPI NOR flash staging area of the XMC1000 Bootloader
+ *
+ **************************************************************************/
+
+#ifndef __SPI_FLASH_H__
+#define __SPI_FLASH_H__
+
+#include "flasher.h"
+
+// ----------------------------------------------------------------------------
+//   public defines
+// ----------------------------------------------------------------------------
+
+// shift clock, at most half of the peripheral clock
+#ifndef SPI_FLASH_BAUD
+#define SPI_FLASH_BAUD         4000000
+#endif
+
+#define SPI_FLASH_SECTOR_SIZE  0x1000      // smallest erase unit
+#define SPI_FLASH_BLOCK_SIZE   0x10000     // large erase unit, used where aligned
+#define SPI_FLASH_MAX_SIZE     0x1000000   // reach of the 3 byte address commands
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+int SpiFlash_Init(void);
+DWORD SpiFlash_Id(void);
+DWORD SpiFlash_Size(void);
+int SpiFlash_Erase(DWORD Addr, DWORD Size);
+void SpiFlash_ReadStart(DWORD Addr, BYTE* Buf, UINT Size);
+void SpiFlash_Read(DWORD Addr, BYTE* Buf, UINT Size);
+int SpiFlash_WriteStart(DWORD Addr, const BYTE* Data);
+int SpiFlash_Poll(void);
+
+#endif  // __SPI_FLASH_H__
@@ -0,0 +1,51 @@
+/**************************************************************************
+ * @file     sram_budget.c
+ * @brief    Stack high-water measurement for the XMC1000 Bootloader
+ *
+ *           The stack size comes from linker_script.ld, where it is set by
+ *           sram_budget.py from the high-water reported by BSL_GET_STATS.
+ *           Everything between the end of .bss and the end of SRAM_1
+ *           (Heap_Bank1) goes to the block pools (mem_pool.c).
+ *
+ **************************************************************************/
+
+#include <XMC1300.h>
+#include "sram_budget.h"
+
+// ----------------------------------------------------------------------------
+//   linker symbols
+// ----------------------------------------------------------------------------
+
+extern unsigned int StackLoadAddr;      // lowest address of the stack
+extern unsigned int __Xmc1300_stack;    // initial stack pointer
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+// Fills the stack below the current frame with STACK_PAINT_WORD. Must be
+// called early in main(), before the stack has grown.
+void StackPaint(void)
+{
+	unsigned int* dst = &StackLoadAddr;
+	unsigned int* sp = (unsigned int*) __get_MSP();
+
+	// keep clear of the frame of this function
+	while (dst < sp - 8)
+		*dst++ = STACK_PAINT_WORD;
+}
+
+UINT StackSize(void)
+{
+	return (UINT)((DWORD)&__Xmc1300_stack - (DWORD)&StackLoadAddr);
+}
+
+// Deepest stack use since StackPaint(), in bytes
+UINT StackHighWater(void)
+{
+	unsigned int* src = &StackLoadAddr;
+
+	while ((src < &__Xmc1300_stack) && (*src == STACK_PAINT_WORD))
+		src++;
+	return (UINT)((DWORD)&__Xmc1300_stack - (DWORD)src);
+}
@@ -0,0 +1,31 @@
+/**************************************************************************
+ * @file     sram_budget.h
+ * @brief    Stack high-water measurement for the XMC1000 Bootloader
+ *
+ **************************************************************************/
+
+#ifndef __SRAM_BUDGET_H__
+#define __SRAM_BUDGET_H__
+
+#include "flasher.h"
+
+// ----------------------------------------------------------------------------
+//   public defines
+// ----------------------------------------------------------------------------
+
+#define STACK_PAINT_WORD       0xA5A5A5A5  // fill pattern of the unused stack
+
+// one received data block (POOL_PAGE block size), DataRx[] layout: 2 pad bytes + DATA_BLOCK_SIZE,
+// rounded up so that the page data (byte 4) stays word aligned
+#define PAGE_BUFFER_WORDS      69
+#define PAGE_BUFFER_SIZE       (PAGE_BUFFER_WORDS * 4)
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+void StackPaint(void);
+UINT StackSize(void);
+UINT StackHighWater(void);
+
+#endif  // __SRAM_BUDGET_H__
@@ -0,0 +1,341 @@
+/**************************************************************************
+ * @file     swd_host.c
+ * @brief    Bit-banged SWD host of the XMC1000 Bootloader
+ *
+ *           With SWD_HOST=1 two GPIOs drive the SWD port of another
+ *           target, BSL_SWD passes batches of DP/AP accesses from the UART
+ *           to it. Both clock edges are single Pn_OMR stores: the falling
+ *           edge sets SWDIO in the same store, the rising edge reads Pn_IN
+ *           right after it. The 8 bit request and the 32 bit data phases
+ *           are unrolled with even clock phases, the other fields use
+ *           loops. SwdHost_SetDelay() slows the clock down for long wires
+ *           or slow targets.
+ *
+ **************************************************************************/
+
+#include <XMC1300.h>
+#include "xmc_gpio.h"
+#include "swd_host.h"
+
+#if SWD_HOST
+
+// ----------------------------------------------------------------------------
+//   local defines
+// ----------------------------------------------------------------------------
+
+#define SWCLK                  (1U << SWD_SWCLK_PIN)
+#define SWDIO                  (1U << SWD_SWDIO_PIN)
+
+#define SWD_JTAG_TO_SWD        0xE79E  // 16 bit switch sequence, LSB first
+
+// Pn_OMR word of a falling SWCLK edge, with SWDIO set for shift 16 and
+// cleared for shift 0
+#define SWD_FALL_OMR(shift)    (((DWORD)SWCLK << 16) | (((DWORD)SWDIO << 16) >> (shift)))
+
+// Keeps the compiler from moving the computation of x into the other
+// clock phase
+#define SWD_PHASE_END(x)       __ASM volatile ("" : "+r" (x))
+
+// One bit of the unrolled writes, out holds its falling edge word. The low
+// phase takes the next bit of data, the high phase turns it into the next
+// falling edge word: one store and two or three ALU cycles per phase.
+#define SWD_WRITE_BIT()                                    \
+	do {                                                   \
+		SWD_PORT->OMR = out;                               \
+		data >>= 1;                                        \
+		shift = (data & 1U) << 4;                          \
+		SWD_PHASE_END(shift);                              \
+		SwdDelay();                                        \
+		XMC_GPIO_ModifyOutput(SWD_PORT, SWCLK, 0);         \
+		out = SWD_FALL_OMR(shift);                         \
+		SWD_PHASE_END(out);                                \
+		SwdDelay();                                        \
+	} while (0)
+
+// One bit of the unrolled reads. The low phase shifts in the level read
+// with the previous rising edge from the top, the high phase reads the
+// next one: one store and three ALU or load cycles per phase.
+#define SWD_READ_BIT()                                     \
+	do {                                                   \
+		XMC_GPIO_ModifyOutput(SWD_PORT, 0, SWCLK);         \
+		data = (data >> 1) | (in << 31);                   \
+		SWD_PHASE_END(data);                               \
+		SwdDelay();                                        \
+		in = XMC_GPIO_ModifyOutputGetInput(SWD_PORT, SWCLK, 0) >> SWD_SWDIO_PIN; \
+		SWD_PHASE_END(in);                                 \
+		SwdDelay();                                        \
+	} while (0)
+
+#define SWD_X8(bit)            bit; bit; bit; bit; bit; bit; bit; bit
+
+// ----------------------------------------------------------------------------
+//   local data
+// ----------------------------------------------------------------------------
+
+static UINT ClockDelay;      // delay loops per clock phase, 0 = full speed
+
+// ----------------------------------------------------------------------------
+//   local functions
+// ----------------------------------------------------------------------------
+
+__STATIC_INLINE void SwdDelay(void)
+{
+	UINT n = ClockDelay;
+
+	while (n--)
+		__NOP();
+}
+
+// Clocks out bits of data, LSB first. The target samples on the rising edge.
+static void SwdWrite(DWORD data, UINT bits)
+{
+	while (bits--)
+	{
+		if (data & 1)
+			XMC_GPIO_ModifyOutput(SWD_PORT, SWDIO, SWCLK);
+		else
+			XMC_GPIO_ModifyOutput(SWD_PORT, 0, SWCLK | SWDIO);
+		data >>= 1;
+		SwdDelay();
+		XMC_GPIO_ModifyOutput(SWD_PORT, SWCLK, 0);
+		SwdDelay();
+	}
+}
+
+// The request, 8 bits unrolled
+static void SwdWriteRequest(DWORD data)
+{
+	DWORD out = SWD_FALL_OMR((data & 1U) << 4);
+	DWORD shift;
+
+	SWD_X8(SWD_WRITE_BIT());
+}
+
+// 32 data bits unrolled
+static void SwdWriteWord(DWORD data)
+{
+	DWORD out = SWD_FALL_OMR((data & 1U) << 4);
+	DWORD shift;
+
+	SWD_X8(SWD_WRITE_BIT());
+	SWD_X8(SWD_WRITE_BIT());
+	SWD_X8(SWD_WRITE_BIT());
+	SWD_X8(SWD_WRITE_BIT());
+}
+
+// Clocks in up to 32 bits, LSB first. The target drives after the rising
+// edge; Pn_IN lags the pin by the input synchronizer, so the level read with
+// the rising edge is the one the target drove during the low phase.
+static DWORD SwdRead(UINT bits)
+{
+	DWORD data = 0;
+	UINT i;
+
+	for (i=0; i<bits; i++)
+	{
+		XMC_GPIO_ModifyOutput(SWD_PORT, 0, SWCLK);
+		SwdDelay();
+		if (XMC_GPIO_ModifyOutputGetInput(SWD_PORT, SWCLK, 0) & SWDIO)
+			data |= 1UL << i;
+		SwdDelay();
+	}
+	return data;
+}
+
+// 32 data bits unrolled, sampled like SwdRead() does. The first shift
+// moves in a 0 that the last one, after the clocks, moves out again.
+static DWORD SwdReadWord(void)
+{
+	DWORD data = 0;
+	DWORD in = 0;
+
+	SWD_X8(SWD_READ_BIT());
+	SWD_X8(SWD_READ_BIT());
+	SWD_X8(SWD_READ_BIT());
+	SWD_X8(SWD_READ_BIT());
+	return (data >> 1) | (in << 31);
+}
+
+// Turnaround cycle, the target takes over SWDIO
+static void SwdTurnIn(void)
+{
+	XMC_GPIO_SetMode(SWD_PORT, SWD_SWDIO_PIN, XMC_GPIO_MODE_INPUT_PULL_UP);
+	(void)SwdRead(1);
+}
+
+// Turnaround cycle, the host takes over SWDIO again
+static void SwdTurnOut(void)
+{
+	(void)SwdRead(1);
+	XMC_GPIO_SetMode(SWD_PORT, SWD_SWDIO_PIN, XMC_GPIO_MODE_OUTPUT_PUSH_PULL);
+}
+
+static UINT SwdParity(DWORD value)
+{
+	value ^= value >> 16;
+	value ^= value >> 8;
+	value ^= value >> 4;
+	value ^= value >> 2;
+	value ^= value >> 1;
+	return value & 1;
+}
+
+// Words up to the next 1 KB boundary, where TAR has to be written again
+static UINT SwdSegment(DWORD addr, UINT count)
+{
+	UINT n = (SWD_TAR_WRAP - (addr & (SWD_TAR_WRAP - 1))) / 4;
+
+	return (n < count) ? n : count;
+}
+
+// AP reads are posted: each DRW read returns the word of the one before,
+// RDBUFF the last one without starting another access
+static BYTE SwdReadSegment(DWORD addr, DWORD* buf, UINT count)
+{
+	DWORD value = addr;
+	BYTE ack;
+	UINT i;
+
+	ack = SwdHost_Transfer(SWD_REQ_APnDP | SWD_AP_TAR, &value);
+	for (i=0; (i<count) && (ack == SWD_ACK_OK); i++)
+		ack = SwdHost_Transfer(SWD_REQ_APnDP | SWD_REQ_RnW | SWD_AP_DRW, i ? &buf[i-1] : &value);
+	if (ack == SWD_ACK_OK)
+		ack = SwdHost_Transfer(SWD_REQ_RnW | SWD_DP_RDBUFF, &buf[count-1]);
+	return ack;
+}
+
+static BYTE SwdWriteSegment(DWORD addr, const DWORD* buf, UINT count)
+{
+	DWORD value = addr;
+	BYTE ack;
+	UINT i;
+
+	ack = SwdHost_Transfer(SWD_REQ_APnDP | SWD_AP_TAR, &value);
+	for (i=0; (i<count) && (ack == SWD_ACK_OK); i++) {
+		value = buf[i];
+		ack = SwdHost_Transfer(SWD_REQ_APnDP | SWD_AP_DRW, &value);
+	}
+	return ack;
+}
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+// SWCLK and SWDIO as outputs, both high (the clock idles high between bits)
+void SwdHost_Init(void)
+{
+	XMC_GPIO_CONFIG_t config;
+
+	config.mode = XMC_GPIO_MODE_OUTPUT_PUSH_PULL;
+	config.input_hysteresis = XMC_GPIO_INPUT_HYSTERESIS_STANDARD;
+	config.output_level = XMC_GPIO_OUTPUT_LEVEL_HIGH;
+	XMC_GPIO_Init(SWD_PORT, SWD_SWCLK_PIN, &config);
+	XMC_GPIO_Init(SWD_PORT, SWD_SWDIO_PIN, &config);
+	ClockDelay = 0;
+}
+
+void SwdHost_SetDelay(UINT Delay)
+{
+	ClockDelay = Delay;
+}
+
+// Line reset, JTAG to SWD switch, line reset and idle, then the DPIDR read
+// that ends the reset state of the DP. Returns the ACK of the read.
+BYTE SwdHost_Connect(DWORD* Idcode)
+{
+	SwdWrite(0xFFFFFFFF, 32);
+	SwdWrite(0xFFFFFFFF, 24);
+	SwdWrite(SWD_JTAG_TO_SWD, 16);
+	SwdWrite(0xFFFFFFFF, 32);
+	SwdWrite(0xFFFFFFFF, 24);
+	SwdWrite(0, 8);
+	return SwdHost_Transfer(SWD_REQ_RnW | SWD_DP_DPIDR, Idcode);
+}
+
+// One DP or AP access, repeated while the target answers WAIT. Read data is
+// stored to *Data only with SWD_ACK_OK. After FAULT or no answer at all the
+// host has to clear the sticky flags (ABORT) or reconnect.
+BYTE SwdHost_Transfer(BYTE Request, DWORD* Data)
+{
+	UINT retries = SWD_WAIT_RETRIES;
+	DWORD request;
+	DWORD value;
+	BYTE ack;
+
+	// start, APnDP, RnW, A[2:3], parity, stop, park
+	Request &= SWD_REQ_APnDP | SWD_REQ_RnW | SWD_REQ_ADDR;
+	request = 0x81 | ((DWORD)Request << 1) | (SwdParity(Request) << 5);
+
+	for (;;)
+	{
+		SwdWriteRequest(request);
+		SwdTurnIn();
+		ack = (BYTE)SwdRead(3);
+		if (ack == SWD_ACK_OK)
+			break;
+		SwdTurnOut();
+		if ((ack != SWD_ACK_WAIT) || !retries--)
+			return ack;
+	}
+
+	if (Request & SWD_REQ_RnW)
+	{
+		value = SwdReadWord();
+		if (SwdRead(1) != SwdParity(value))
+			ack = SWD_ACK_PARITY;
+		else
+			*Data = value;
+		SwdTurnOut();
+	}
+	else
+	{
+		SwdTurnOut();
+		SwdWriteWord(*Data);
+		SwdWrite(SwdParity(*Data), 1);
+	}
+	SwdWrite(0, SWD_IDLE_CYCLES);
+	return ack;
+}
+
+// Reads Count words of target memory at the word address Addr through DRW
+// of the selected AP, whose CSW must select 32 bit accesses with single
+// address increment. TAR is written once per 1 KB segment, RDBUFF read once
+// at its end. Returns the ACK of the failed access or SWD_ACK_OK.
+BYTE SwdHost_ReadBlock(DWORD Addr, DWORD* Buf, UINT Count)
+{
+	BYTE ack = SWD_ACK_OK;
+	UINT n;
+
+	while (Count && (ack == SWD_ACK_OK)) {
+		n = SwdSegment(Addr, Count);
+		ack = SwdReadSegment(Addr, Buf, n);
+		Addr += n * 4;
+		Buf += n;
+		Count -= n;
+	}
+	return ack;
+}
+
+// Writes Count words like SwdHost_ReadBlock() reads them. The write
+// responses are posted too: the closing RDBUFF read waits for the last one
+// and reports a failed write as FAULT.
+BYTE SwdHost_WriteBlock(DWORD Addr, const DWORD* Buf, UINT Count)
+{
+	DWORD value;
+	BYTE ack = SWD_ACK_OK;
+	UINT n;
+
+	while (Count && (ack == SWD_ACK_OK)) {
+		n = SwdSegment(Addr, Count);
+		ack = SwdWriteSegment(Addr, Buf, n);
+		Addr += n * 4;
+		Buf += n;
+		Count -= n;
+	}
+	if (ack == SWD_ACK_OK)
+		ack = SwdHost_Transfer(SWD_REQ_RnW | SWD_DP_RDBUFF, &value);
+	return ack;
+}
+
+#endif  // SWD_HOST
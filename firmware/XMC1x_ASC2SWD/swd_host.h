@@ -0,0 +1,60 @@
+/**************************************************************************
+ * @file     swd_host.h
+ * @brief    Bit-banged SWD host of the XMC1000 Bootloader
+ *
+ **************************************************************************/
+
+#ifndef __SWD_HOST_H__
+#define __SWD_HOST_H__
+
+#include "flasher.h"
+
+// ----------------------------------------------------------------------------
+//   public defines
+// ----------------------------------------------------------------------------
+
+// SWCLK and SWDIO, two pins of one port
+#ifndef SWD_PORT
+#define SWD_PORT               XMC_GPIO_PORT0
+#define SWD_SWCLK_PIN          0
+#define SWD_SWDIO_PIN          1
+#endif
+
+// request byte: APnDP, RnW and A[3:2] in the bit positions of the request
+// phase, so the register addresses below can be or'ed in directly
+#define SWD_REQ_APnDP          0x01
+#define SWD_REQ_RnW            0x02
+#define SWD_REQ_ADDR           0x0C
+
+#define SWD_DP_DPIDR           0x00    // read
+#define SWD_DP_ABORT           0x00    // write
+#define SWD_DP_CTRL_STAT       0x04
+#define SWD_DP_SELECT          0x08
+#define SWD_DP_RDBUFF          0x0C
+
+#define SWD_AP_CSW             0x00
+#define SWD_AP_TAR             0x04
+#define SWD_AP_DRW             0x0C
+
+// ACK of a transfer, SWD_ACK_PARITY is not on the wire
+#define SWD_ACK_OK             0x01
+#define SWD_ACK_WAIT           0x02
+#define SWD_ACK_FAULT          0x04
+#define SWD_ACK_PARITY         0x08    // read data with a parity error
+
+#define SWD_WAIT_RETRIES       100
+#define SWD_IDLE_CYCLES        2       // after each transfer, clocks a posted write into the AP
+#define SWD_TAR_WRAP           0x400   // TAR auto increment is only defined within 1 KB
+
+// ----------------------------------------------------------------------------
+//   public functions
+// ----------------------------------------------------------------------------
+
+void SwdHost_Init(void);
+void SwdHost_SetDelay(UINT Delay);
+BYTE SwdHost_Connect(DWORD* Idcode);
+BYTE SwdHost_Transfer(BYTE Request, DWORD* Data);
+BYTE SwdHost_ReadBlock(DWORD Addr, DWORD* Buf, UINT Count);
+BYTE SwdHost_WriteBlock(DWORD Addr, const DWORD* Buf, UINT Count);
+
+#endif  // __SWD_HOST_H__
@@ -24,6 +24,7 @@
  **************************************************************************/
  
 #include "xmc1000_flasher.h"
+#include "xmc_pau.h"
 
 // ----------------------------------------------------------------------------
 //   local prototypes
@@ -31,20 +32,136 @@
 
 extern BYTE* p;
 
+static void ScanSector(unsigned int Sector);
+static void ForgetSector(unsigned int Sector);
+
 // ----------------------------------------------------------------------------
 //   local data
 // ----------------------------------------------------------------------------
 
+// Blank page cache: one bit per flash page, valid for sectors whose bit is
+// set in SectorScanned[]. A sector is scanned the first time it is queried,
+// so flash beyond the size of the actual device is never read.
+static uint32_t PageBlank[(XMC1000_FLASH_PAGES + 31) / 32];
+static uint32_t SectorScanned[(XMC1000_FLASH_SECTORS + 31) / 32];
+
+// Background (lazy) erase: sectors erased since loader start and the page
+// walk of the erase that is currently running
+#define NVM_ACTION_CONTINUOUS_PAGE_ERASE  0xA2
+static uint32_t SectorErased[(XMC1000_FLASH_SECTORS + 31) / 32];
+static unsigned long EraseAddr;       // next page to erase
+static unsigned long EraseEnd;        // end of the sector being erased
+static unsigned long EraseCurrent;    // page the NVM is erasing, 0 if none
+static int EraseActive;
+static int EraseError;
+
+// Background page write (windowed program sessions): one 16 byte block per
+// poll, as continuous write and then as continuous verify-only pass
+#define NVM_ACTION_CONTINUOUS_WRITE       0xA1
+#define NVM_ACTION_CONTINUOUS_VERIFY      0xE0
+static const uint32_t* WriteSrc;
+static unsigned long WriteAddr;       // page being written
+static unsigned int WriteBlock;       // blocks issued in the current pass
+static int WritePass;                 // 0 idle, 1 write, 2 verify
+static int WriteVerify;
+static int WriteError;
+
+// CRC-32 (IEEE 802.3, reflected, as zlib.crc32), one nibble per lookup
+static const uint32_t Crc32Nibble[16] =
+{
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+
+// ----------------------------------------------------------------------------
+//   local functions
+// ----------------------------------------------------------------------------
+
+static void ScanSector(unsigned int Sector)
+{
+	const uint32_t* src = (const uint32_t*) XMC_FLASH_GetSectorAddress(Sector);
+	unsigned int page = Sector * XMC_FLASH_PAGES_PER_SECTOR;
+	unsigned int end = page + XMC_FLASH_PAGES_PER_SECTOR;
+	unsigned int i;
+	uint32_t diff;
+
+	for (; page < end; page++)
+	{
+		// 4 words per iteration, any bit different from the erased value marks the page
+		diff = 0;
+		for (i=0;i<XMC_FLASH_WORDS_PER_PAGE;i+=4)
+		{
+			diff |= (src[0] ^ FLASH_ERASED_WORD) | (src[1] ^ FLASH_ERASED_WORD) |
+			        (src[2] ^ FLASH_ERASED_WORD) | (src[3] ^ FLASH_ERASED_WORD);
+			src += 4;
+		}
+		if (diff == 0)
+			PageBlank[page >> 5] |= (1UL << (page & 31));
+		else
+			PageBlank[page >> 5] &= ~(1UL << (page & 31));
+	}
+	SectorScanned[Sector >> 5] |= (1UL << (Sector & 31));
+}
+
+static void ForgetSector(unsigned int Sector)
+{
+	SectorScanned[Sector >> 5] &= ~(1UL << (Sector & 31));
+}
 
 // ----------------------------------------------------------------------------
 //   public functions
 // ----------------------------------------------------------------------------
 
+int XMC1000_FLASH_IsPageBlank(unsigned long PageAddr)
+{
+	unsigned int page;
+	unsigned int sector;
+
+	if ((PageAddr < XMC_FLASH_BASE) || (PageAddr >= XMC_FLASH_BASE + XMC1000_FLASH_GetSize()))
+		return 0;
+
+	page = (PageAddr - XMC_FLASH_BASE) / XMC1000_FLASH_PAGE_SIZE;
+	sector = page / XMC_FLASH_PAGES_PER_SECTOR;
+	if (!(SectorScanned[sector >> 5] & (1UL << (sector & 31))))
+		ScanSector(sector);
+
+	return (PageBlank[page >> 5] >> (page & 31)) & 1;
+}
+
+int XMC1000_FLASH_IsRangeBlank(unsigned long Addr, unsigned long Size)
+{
+	unsigned long page = Addr & ~(unsigned long)(XMC1000_FLASH_PAGE_SIZE - 1);
+
+	// page granularity: a partly covered page must be blank as a whole
+	for (; page < Addr + Size; page += XMC1000_FLASH_PAGE_SIZE)
+	{
+		if (!XMC1000_FLASH_IsPageBlank(page))
+			return 0;
+	}
+	return 1;
+}
+
+void XMC1000_FLASH_MarkPage(unsigned long PageAddr, int Blank)
+{
+	unsigned int page;
+
+	if ((PageAddr < XMC_FLASH_BASE) || (PageAddr >= XMC_FLASH_BASE + XMC1000_FLASH_GetSize()))
+		return;
+
+	page = (PageAddr - XMC_FLASH_BASE) / XMC1000_FLASH_PAGE_SIZE;
+	if (Blank)
+		PageBlank[page >> 5] |= (1UL << (page & 31));
+	else
+		PageBlank[page >> 5] &= ~(1UL << (page & 31));
+}
+
 int XMC1000_FLASH_ProgramPage(unsigned long PageAddr)
 {
 	signed long error;
 
-	error = XMC1000_NvmProgVerify((unsigned long *) (p+2), (unsigned long * )PageAddr);
+	error = XMC1000_NvmProgVerify((const uint32_t *) (p+2), (uint32_t * )PageAddr);
+	XMC1000_FLASH_MarkPage(PageAddr, 0);
 	if (error == BSL_NVM_OK) return FLASHER_SUCCESS;
 	else return FLASHER_E_FAILED;
 
@@ -52,6 +169,195 @@ int XMC1000_FLASH_ProgramPage(unsigned long PageAddr)
 
 
 
+// Fast path for pages that are already erased: continuous write of the
+// 16 byte blocks without the erase step of NvmProgVerify. The optional
+// verify runs as a separate continuous verify-only pass over the page.
+int XMC1000_FLASH_WritePage(unsigned long PageAddr, int Verify)
+{
+	const uint32_t* src = (const uint32_t*) (p+2);
+	uint32_t* dst = (uint32_t*) PageAddr;
+
+	// a written word would corrupt the page, let the ROM erase it first
+	if (!XMC1000_FLASH_IsPageBlank(PageAddr))
+		return XMC1000_FLASH_ProgramPage(PageAddr);
+
+	XMC_FLASH_WriteBlocks(dst, src, XMC_FLASH_BLOCKS_PER_PAGE, false);
+	XMC1000_FLASH_MarkPage(PageAddr, 0);
+	if (XMC_FLASH_GetStatus() & (NVM_NVMSTATUS_WRPERR_Msk | NVM_NVMSTATUS_VERR_Msk))
+		return FLASHER_E_FAILED;
+
+	if (Verify)
+	{
+		XMC_FLASH_VerifyBlocks(dst, src, XMC_FLASH_BLOCKS_PER_PAGE);
+		if (XMC_FLASH_GetStatus() & NVM_NVMSTATUS_VERR_Msk)
+			return FLASHER_E_FAILED;
+	}
+	return FLASHER_SUCCESS;
+}
+
+
+// Starts a background write of the page at p+2 to PageAddr. Pages that are
+// not blank go through the erasing NvmProgVerify at once (blocking).
+void XMC1000_FLASH_WriteStart(unsigned long PageAddr, int Verify)
+{
+	WriteError = 0;
+	WritePass = 0;
+	if (!XMC1000_FLASH_IsPageBlank(PageAddr))
+	{
+		WriteError = XMC1000_FLASH_ProgramPage(PageAddr);
+		return;
+	}
+
+	WriteSrc = (const uint32_t*) (p+2);
+	WriteAddr = PageAddr;
+	WriteBlock = 0;
+	WriteVerify = Verify;
+
+	NVM->NVMPROG &= (uint16_t)(~(uint16_t)NVM_NVMPROG_ACTION_Msk);
+	NVM->NVMPROG |= (uint16_t)(NVM_NVMPROG_RSTVERR_Msk | NVM_NVMPROG_RSTECC_Msk |
+	                           NVM_ACTION_CONTINUOUS_WRITE);
+	WritePass = 1;
+	(void)XMC1000_FLASH_WritePoll();
+}
+
+// Cheap enough to be called while waiting for a received byte. Returns 1
+// as long as the background write is running.
+int XMC1000_FLASH_WritePoll(void)
+{
+	const uint32_t* src;
+	volatile uint32_t* dst;
+
+	if (!WritePass)
+		return 0;
+	if (XMC_FLASH_IsBusy())
+		return 1;
+
+	if (WriteBlock == XMC_FLASH_BLOCKS_PER_PAGE)
+	{
+		NVM->NVMPROG &= (uint16_t)(~(uint16_t)NVM_NVMPROG_ACTION_Msk);
+		if (WritePass == 1)
+			XMC1000_FLASH_MarkPage(WriteAddr, 0);
+		if (XMC_FLASH_GetStatus() & (NVM_NVMSTATUS_WRPERR_Msk | NVM_NVMSTATUS_VERR_Msk))
+			WriteError = FLASHER_E_FAILED;
+		if ((WritePass == 2) || !WriteVerify || WriteError)
+		{
+			WritePass = 0;
+			return 0;
+		}
+
+		// same data again, the NVM compares instead of writing
+		NVM->NVMPROG |= (uint16_t)(NVM_NVMPROG_RSTVERR_Msk | NVM_ACTION_CONTINUOUS_VERIFY);
+		WriteBlock = 0;
+		WritePass = 2;
+	}
+
+	src = WriteSrc + WriteBlock * XMC_FLASH_WORDS_PER_BLOCK;
+	dst = (volatile uint32_t*) (WriteAddr + WriteBlock * XMC_FLASH_BYTES_PER_BLOCK);
+	dst[0] = src[0];
+	dst[1] = src[1];
+	dst[2] = src[2];
+	dst[3] = src[3];
+	WriteBlock++;
+	return 1;
+}
+
+// Waits for the background write, FLASHER_E_FAILED if it or its verify failed
+int XMC1000_FLASH_WriteFinish(void)
+{
+	int error;
+
+	while (XMC1000_FLASH_WritePoll()) {}
+
+	error = WriteError;
+	WriteError = 0;
+	return error ? FLASHER_E_FAILED : FLASHER_SUCCESS;
+}
+
+
+// Starts a background erase of the sector holding PageAddr, unless that
+// sector was already erased since loader start. Blank pages are skipped,
+// the rest is advanced by XMC1000_FLASH_ErasePoll().
+void XMC1000_FLASH_EraseStart(unsigned long PageAddr)
+{
+	unsigned int sector;
+
+	if (EraseActive || (PageAddr < XMC_FLASH_BASE) || (PageAddr >= XMC_FLASH_BASE + XMC1000_FLASH_GetSize()))
+		return;
+
+	sector = (PageAddr - XMC_FLASH_BASE) / XMC_FLASH_BYTES_PER_SECTOR;
+	if (SectorErased[sector >> 5] & (1UL << (sector & 31)))
+		return;
+	SectorErased[sector >> 5] |= (1UL << (sector & 31));
+
+	EraseAddr = XMC_FLASH_GetSectorAddress(sector);
+	EraseEnd = EraseAddr + XMC_FLASH_BYTES_PER_SECTOR;
+	EraseCurrent = 0;
+	EraseError = 0;
+
+	// scan the sector now, flash must not be read while the erase runs
+	(void)XMC1000_FLASH_IsPageBlank(EraseAddr);
+
+	NVM->NVMPROG &= (uint16_t)(~(uint16_t)NVM_NVMPROG_ACTION_Msk);
+	NVM->NVMPROG |= (uint16_t)(NVM_NVMPROG_RSTVERR_Msk | NVM_NVMPROG_RSTECC_Msk |
+	                           NVM_ACTION_CONTINUOUS_PAGE_ERASE);
+	EraseActive = 1;
+	(void)XMC1000_FLASH_ErasePoll();
+}
+
+// Cheap enough to be called while waiting for a received byte. Returns 1
+// as long as the background erase is running.
+int XMC1000_FLASH_ErasePoll(void)
+{
+	if (!EraseActive)
+		return 0;
+	if (XMC_FLASH_IsBusy())
+		return 1;
+
+	if (EraseCurrent)
+	{
+		if (XMC_FLASH_GetStatus() & NVM_NVMSTATUS_WRPERR_Msk)
+			EraseError = 1;
+		else
+			XMC1000_FLASH_MarkPage(EraseCurrent, 1);
+		EraseCurrent = 0;
+	}
+
+	while ((EraseAddr < EraseEnd) && XMC1000_FLASH_IsPageBlank(EraseAddr))
+		EraseAddr += XMC1000_FLASH_PAGE_SIZE;
+
+	if ((EraseAddr >= EraseEnd) || EraseError)
+	{
+		NVM->NVMPROG &= (uint16_t)(~(uint16_t)NVM_NVMPROG_ACTION_Msk);
+		EraseActive = 0;
+		return 0;
+	}
+
+	// a write to the page start triggers the page erase
+	EraseCurrent = EraseAddr;
+	*(volatile uint32_t*)EraseCurrent = 0;
+	EraseAddr += XMC1000_FLASH_PAGE_SIZE;
+	return 1;
+}
+
+// Waits for the background erase. On a failure the sector is rescanned on
+// its next use, so its pages go through the erasing NvmProgVerify path.
+int XMC1000_FLASH_EraseFinish(void)
+{
+	int error;
+
+	while (XMC1000_FLASH_ErasePoll()) {}
+
+	error = EraseError;
+	EraseError = 0;
+	if (error)
+	{
+		ForgetSector((EraseEnd - 1 - XMC_FLASH_BASE) / XMC_FLASH_BYTES_PER_SECTOR);
+		return FLASHER_E_FAILED;
+	}
+	return FLASHER_SUCCESS;
+}
+
+
 int XMC1000_FLASH_EraseSector(unsigned long SectorAddr)
 {
 	signed long error = 0;
@@ -59,12 +365,44 @@ int XMC1000_FLASH_EraseSector(unsigned long SectorAddr)
 
 	for (i=0;i<16;i++)
 	{
-		SectorAddr = SectorAddr + i*256 ;
-		error = XMC1000_NvmErasePage((unsigned long *)SectorAddr);
-
+		error = XMC1000_NvmErasePage((uint32_t *)(SectorAddr + i*256));
+		if (error != BSL_NVM_OK) break;
+		XMC1000_FLASH_MarkPage(SectorAddr + i*256, 1);
 	}
+	if ((error != BSL_NVM_OK) && (SectorAddr >= XMC_FLASH_BASE))
+		ForgetSector((SectorAddr - XMC_FLASH_BASE) / XMC_FLASH_BYTES_PER_SECTOR);
 	if (error == BSL_NVM_OK) return FLASHER_SUCCESS;
 	else return FLASHER_E_FAILED;
 
 }
 
+
+// Flash size of this device from PAU FLSIZE, at most the XMC1000_FLASH_SIZE
+// the page tables are sized for
+unsigned long XMC1000_FLASH_GetSize(void)
+{
+	unsigned long size = XMC_PAU_GetFlashSize() * 1024UL;
+
+	return (size < XMC1000_FLASH_SIZE) ? size : XMC1000_FLASH_SIZE;
+}
+
+unsigned long XMC1000_FLASH_Crc32(unsigned long Addr, unsigned long Size)
+{
+	return XMC1000_FLASH_Crc32Add(0, Addr, Size);
+}
+
+// Continues the CRC-32 Crc of the bytes before Addr (0 for none) over Size
+// more bytes, Addr may be in SRAM
+unsigned long XMC1000_FLASH_Crc32Add(unsigned long Crc, unsigned long Addr, unsigned long Size)
+{
+	const BYTE* src = (const BYTE*) Addr;
+	uint32_t crc = ~(uint32_t)Crc;
+
+	while (Size--)
+	{
+		crc ^= *src++;
+		crc = (crc >> 4) ^ Crc32Nibble[crc & 0x0F];
+		crc = (crc >> 4) ^ Crc32Nibble[crc & 0x0F];
+	}
+	return ~crc;
+}
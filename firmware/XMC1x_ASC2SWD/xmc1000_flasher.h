@@ -28,41 +28,31 @@
 // include common definitions
 #include "flasher.h"
 
-// ----------------------------------------------------------------------------
-//   public defines
-// ----------------------------------------------------------------------------
-
-/* Constants definitions */
-#define ROM_FUNCTION_TABLE_START    (0x00000100)				      ///< Start address of the ROM function table
-
-#define _NvmErase	                (ROM_FUNCTION_TABLE_START + 0x00) ///< Pointer to Erase Flash Page routine
-#define _NvmProgVerify	          (ROM_FUNCTION_TABLE_START + 0x04) ///< Pointer to Erase, Program & Verify Flash Page routine
-#define _BmiInstallationReq	      (ROM_FUNCTION_TABLE_START + 0x08) ///< Pointer to Request BMI installation routine
-
-/* Types definitions */
-typedef enum tagNVMStatus
-{
-    NVM_PASS                              = (signed long) 0x00010000,   ///< the function succeeded
-    NVM_E_FAIL                            = (signed long) 0x80010001,   ///< generic error code
-    NVM_E_SRC_AREA_EXCCEED                = (signed long) 0x80010003,   ///< source data not in RAM
-    NVM_E_SRC_ALIGNMENT                   = (signed long) 0x80010004,   ///< source data is not 4 byte aligned
-    NVM_E_NVM_FAIL                        = (signed long) 0x80010005,   ///< NVM module cannot be physically accessed
-    NVM_E_VERIFY                          = (signed long) 0x80010006,   ///< verification of written page not successful
-    NVM_E_DST_AREA_EXCEED                 = (signed long) 0x80010009,   ///< destination data is not (completely) located in NVM
-    NVM_E_DST_ALIGNMENT                   = (signed long) 0x80010010,   ///< destination data is not properly aligned
-} NVM_STATUS;
-
+// XMCLib flash driver, brings in the ROM function table (XMC1000_RomFunctionTable.h)
+#include "xmc_flash.h"
 
 // MACRO:  Device specific defines ------------------------------------------
 #define XMC1000_FLASH_PAGE_SIZE   256  // program FLASH page size
-#define XMC1000_NvmErasePage (*((NVM_STATUS (**) (unsigned long * )) _NvmErase)) //addr. must be page aligned, pass = 0x00010000
-#define  XMC1000_NvmProgVerify	        (*((NVM_STATUS (**) (unsigned long * , unsigned long * )) _NvmProgVerify)) //addr. must be page aligned, pass= 0x00010000
-#define  XMC1000_BmiInstallationReq	    (*((unsigned long (**) (unsigned short)) _BmiInstallationReq)) //BMI value to be install, if OK will trigger reset and does not return to calling routine.
+#define XMC1000_FLASH_SIZE        0x32000  // largest XMC1300 flash, sizes the page tables; see XMC1000_FLASH_GetSize()
+#define XMC1000_FLASH_PAGES       (XMC1000_FLASH_SIZE / XMC1000_FLASH_PAGE_SIZE)
+#define XMC1000_FLASH_SECTORS     (XMC1000_FLASH_SIZE / XMC_FLASH_BYTES_PER_SECTOR)
 //
 // --------------------------------------------------------------------------
 
 int XMC1000_FLASH_ProgramPage(unsigned long PageAddr);
+int XMC1000_FLASH_WritePage(unsigned long PageAddr, int Verify);
 int XMC1000_FLASH_EraseSector(unsigned long SectorAddr);
-void ASC_Init(void);
+int XMC1000_FLASH_IsPageBlank(unsigned long PageAddr);
+int XMC1000_FLASH_IsRangeBlank(unsigned long Addr, unsigned long Size);
+void XMC1000_FLASH_MarkPage(unsigned long PageAddr, int Blank);
+void XMC1000_FLASH_EraseStart(unsigned long PageAddr);
+int XMC1000_FLASH_ErasePoll(void);
+int XMC1000_FLASH_EraseFinish(void);
+void XMC1000_FLASH_WriteStart(unsigned long PageAddr, int Verify);
+int XMC1000_FLASH_WritePoll(void);
+int XMC1000_FLASH_WriteFinish(void);
+unsigned long XMC1000_FLASH_Crc32(unsigned long Addr, unsigned long Size);
+unsigned long XMC1000_FLASH_GetSize(void);
+unsigned long XMC1000_FLASH_Crc32Add(unsigned long Crc, unsigned long Addr, unsigned long Size);
 
 #endif  // __XMC1000_FLASHER_H__
@@ -0,0 +1,80 @@
+import subprocess
+import argparse
+import re
+
+# Sizes the stack of the SRAM loader from a measured high-water (see
+# "xmc_loader.py --stats") and reports how much SRAM is left for page
+# buffers. The stack_size line of the linker script is rewritten in place,
+# everything behind .bss becomes page buffers at link time.
+
+LINKER_SCRIPT = "firmware/XMC1x_ASC2SWD/linker_script.ld"
+SIZE_TOOL = "arm-none-eabi-size"
+
+parser = argparse.ArgumentParser(description="SRAM budget of the XMC1000 SRAM loader")
+parser.add_argument("elf", help="linked loader image")
+parser.add_argument("--stack-hw", type=int, help="measured stack high-water in bytes")
+parser.add_argument("--margin", type=int, default=32, help="bytes added to the high-water (default: %(default)s)")
+parser.add_argument("--ld", default=LINKER_SCRIPT, help="linker script to update (default: %(default)s)")
+parser.add_argument("--size-tool", default=SIZE_TOOL, help="size utility (default: %(default)s)")
+args = parser.parse_args()
+
+try:
+    script = open(args.ld).read()
+except Exception:
+    print("ERROR: Could not open", args.ld)
+    exit(1)
+
+memory = re.search(r"SRAM_1\(!RX\)\s*:\s*ORIGIN\s*=\s*(\w+),\s*LENGTH\s*=\s*(\w+)", script)
+stack = re.search(r"^stack_size\s*=\s*(\d+);", script, re.M)
+buffer = re.search(r"^page_buffer_size\s*=\s*(\d+);", script, re.M)
+if (not memory or not stack or not buffer):
+    print("ERROR: SRAM_1, stack_size or page_buffer_size not found in", args.ld)
+    exit(1)
+
+sramSize = int(memory.group(2), 0)
+stackSize = int(stack.group(1))
+bufferSize = int(buffer.group(1))
+
+try:
+    out = subprocess.check_output([args.size_tool, "-A", args.elf]).decode()
+except Exception:
+    print("ERROR: Could not run", args.size_tool, "on", args.elf)
+    exit(1)
+
+sections = {}
+for line in out.splitlines():
+    fields = line.split()
+    if (len(fields) == 3 and fields[1].isdigit()):
+        sections[fields[0]] = int(fields[1])
+
+
+def align(value, to):
+    return (value + to - 1) & ~(to - 1)
+
+
+code = sections.get(".text", 0) + sections.get(".ARM.exidx", 0) + sections.get(".rodata", 0)
+data = sections.get(".data", 0)
+bss = sections.get(".bss", 0)
+
+if (args.stack_hw is not None):
+    stackSize = max(align(args.stack_hw + args.margin, 8), 64)
+
+# mirrors linker_script.ld: code (16 byte aligned), data, stack, bss, heap
+# (page buffers, mem_pool.c)
+used = align(code, 16) + align(data, 4)
+used = align(used, 8) + stackSize + align(bss, 4)
+spare = sramSize - align(used, 8)
+
+print("Code + rodata:", code, "bytes")
+print("Data:", data, "bytes, BSS:", bss, "bytes")
+print("Stack:", stackSize, "bytes")
+print("Page buffers:", max(spare, 0) // bufferSize, "x", bufferSize, "bytes")
+
+if (spare < bufferSize):
+    print("ERROR: No SRAM left for a page buffer")
+    exit(1)
+
+if (args.stack_hw is not None):
+    script = script[:stack.start()] + "stack_size = %d;" % stackSize + script[stack.end():]
+    open(args.ld, "w").write(script)
+    print("Updated", args.ld, "- relink to apply")
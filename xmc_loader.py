@@ -3,20 +3,111 @@ from time import time
 import sys
 import os
 from array import array
+import argparse
+import zlib
 
 SERIAL = "COM23"
 BAUDRATE = 115200
 TIMEOUT = 200
+STAGE_ERASE_TIMEOUT = 2000    # per 64 KB block of the SPI flash
+COMMIT_PAGE_TIMEOUT = 20      # per page programmed from the SPI flash
+CRC_PAGE_TIMEOUT = 2          # per page of the FINALIZE CRC, about 20 cycles per byte at 8 MHz
 
-if (len(sys.argv) < 2):
-    print("ERROR: Missing .bin file!")
-    exit(1)
+# SRAM loader protocol (firmware/XMC1x_ASC2SWD/flasher.h)
+PAGE_SIZE = 256
+SECTOR_SIZE = 4096
+FLASH_BASE = 0x10001000
 
-if (len(sys.argv) > 2):
-    print("ERROR: Unexpected arguments!")
-    exit(1)
+HEADER_BLOCK = 0x00
+DATA_BLOCK = 0x01
+EOT_BLOCK = 0x02
+
+BSL_PROGRAM_FLASH = 0x00
+BSL_CHANGE_BMI = 0x01
+BSL_ERASE_FLASH = 0x03
+BSL_READ_FLASH = 0x04
+BSL_GET_STATS = 0x05
+BSL_FINALIZE = 0x06
+BSL_GET_INFO = 0x07
+BSL_STAGE_COMMIT = 0x08
+BSL_SWD = 0x09
+
+BSL_INFO_LOADER = 0x00
+BSL_INFO_CHIP = 0x01
+BSL_INFO_STAGE = 0x02
+
+BSL_SWD_CONNECT = 0x00
+BSL_SWD_TRANSFER = 0x01
+BSL_SWD_READ_BLOCK = 0x02
+BSL_SWD_WRITE_BLOCK = 0x03
+SWD_BATCH_MAX = 48
+SWD_BLOCK_MAX = 64    # words per block access
+
+SWD_REQ_APnDP = 0x01
+SWD_REQ_RnW = 0x02
+SWD_DP_DPIDR = 0x00
+SWD_DP_ABORT = 0x00
+SWD_DP_CTRL_STAT = 0x04
+SWD_DP_SELECT = 0x08
+SWD_DP_RDBUFF = 0x0C
+SWD_AP_CSW = 0x00
+SWD_CSW_WORD_INC = 0x23000012    # 32 bit accesses, single address increment
+SWD_ACK_OK = 0x01
 
-binName = sys.argv[1]
+BSL_STATS_SRAM = 0x00
+BSL_STATS_POOL = 0x01
+POOL_NAMES = ["Page"]
+
+BSL_PROG_ERASED = 0x01
+BSL_PROG_VERIFY = 0x02
+BSL_PROG_LAZY_ERASE = 0x04
+BSL_PROG_SEQUENCE = 0x08
+BSL_PROG_WINDOW = 0x10
+BSL_PROG_STAGE = 0x20
+
+BSL_BLOCK_TYPE_ERROR = 0xFF
+BSL_CHKSUM_ERROR = 0xFD
+BSL_SEQUENCE_ERROR = 0xF7
+# NAKs of a BSL_PROG_SEQUENCE session, the block named in the reply is sent again
+BLOCK_NAKS = (BSL_BLOCK_TYPE_ERROR, BSL_CHKSUM_ERROR, BSL_SEQUENCE_ERROR)
+BLOCK_RETRIES = 8
+
+BSL_SUCCESS = 0x55
+BSL_ERASE_SUCCESS = 0x50
+BSL_VERIFY_ERROR = 0xF8
+
+parser = argparse.ArgumentParser(description="Load a firmware to XMC1000 SRAM through the ASC BSL")
+parser.add_argument("bin", help="firmware to load into SRAM (.bin)")
+parser.add_argument("--port", default=SERIAL, help="serial port (default: %(default)s)")
+parser.add_argument("--stage1", metavar="BIN",
+                    help="upload this first stage through the ROM BSL, then bin through it (compressed, at --baud)")
+# stage 1 keeps the 8 MHz reset MCLK, the USIC tops out at about 499 kbaud there
+parser.add_argument("--baud", type=int, default=460800, help="baud rate after stage 1 (default: %(default)s)")
+parser.add_argument("--mclk", type=int, default=8000000, help="MCLK of the target in Hz (default: %(default)s)")
+parser.add_argument("--program", metavar="BIN", help="flash image to program through the SRAM loader")
+parser.add_argument("--address", type=lambda x: int(x, 0), default=FLASH_BASE,
+                    help="flash address of --program (default: 0x%(default)X)")
+parser.add_argument("--lazy-erase", action="store_true",
+                    help="let the loader erase each sector when its first page arrives")
+parser.add_argument("--stage", action="store_true",
+                    help="stage --program in the SPI flash of the board, then let the loader program it (SPI_FLASH loaders)")
+parser.add_argument("--stage-address", type=lambda x: int(x, 0), default=0,
+                    help="SPI flash address of the staged image (default: 0x%(default)X)")
+parser.add_argument("--verify", action="store_true", help="read back the programmed image")
+parser.add_argument("--stats", action="store_true", help="print stack high-water and buffer budget")
+parser.add_argument("--info", action="store_true", help="print protocol version, features and flash geometry")
+parser.add_argument("--swd", action="store_true",
+                    help="connect to a target on the SWD host pins and print its DP and AP IDs (SWD_HOST=1 loader)")
+parser.add_argument("--swd-write", metavar="BIN",
+                    help="write an image into the memory of the SWD target and read it back (implies --swd)")
+parser.add_argument("--swd-address", type=lambda x: int(x, 0), default=0x20000000,
+                    help="target address of --swd-write (default: %(default)#x)")
+parser.add_argument("--swd-delay", type=int, default=0, help="SWD clock delay loops per clock phase (default: 0)")
+parser.add_argument("--bmi", type=lambda x: int(x, 0), help="BMI value to install last (ex: 0xF8C3 for SWD)")
+args = parser.parse_args()
+args.swd = args.swd or args.swd_write is not None
+
+binName = args.stage1 if args.stage1 else args.bin
 if not(binName.endswith(".bin")):
     print("ERROR: Only .bin files are supported!")
     exit(1)
@@ -39,7 +130,7 @@ binData = array('B')
 binData.fromfile(binFile, binSize)
 binFile.close()
 
-ser = serial.Serial(port=SERIAL, baudrate=BAUDRATE, timeout=TIMEOUT/1000.0)
+ser = serial.Serial(port=args.port, baudrate=BAUDRATE, timeout=TIMEOUT/1000.0)
 
 while (ser.read()):
     pass
@@ -53,7 +144,7 @@ while (True):
             print("ERROR: Expected BSL_ID 0x5d, received:", hex(byte[0]))
             exit(1)
         break
-    
+
 print("Sending length...")
 ser.write(bytearray(sizeArray))
 print("Length: ", sizeArray)
@@ -79,4 +170,425 @@ else:
     print("ERROR: No response to program flash")
     exit(1)
 
-print("Success!")
\ No newline at end of file
+print("Success!")
+
+
+def xor(data):
+    chksum = 0
+    for b in data:
+        chksum ^= b
+    return chksum
+
+
+def expect(what, ok):
+    byte = ser.read()
+    if (not byte):
+        print("ERROR: No response to", what)
+        exit(1)
+    if (byte[0] != ok):
+        print("ERROR:", what, "failed, received:", hex(byte[0]))
+        exit(1)
+
+
+def send_header(mode, payload):
+    block = bytearray([HEADER_BLOCK, mode]) + payload
+    block += bytearray(15 - len(block))
+    block.append(xor(block[1:]))
+    ser.write(block)
+
+
+def eot_block(seq):
+    block = bytearray([EOT_BLOCK, seq & 0xFF]) + bytearray(13)
+    block.append(xor(block[1:]))
+    return block
+
+
+def data_block(seq, data):
+    block = bytearray([DATA_BLOCK, seq & 0xFF]) + data + bytearray(5)
+    block.append(xor(block[1:]))
+    return block
+
+
+def usic_divider(mclk, baud):
+    # fractional divider: baud = mclk * STEP / 1024 / (PDIV + 1) / 16
+    best = None
+    for pdiv in range(1024):
+        step = round(baud * 16 * (pdiv + 1) * 1024 / mclk)
+        if (step < 1 or step > 1023):
+            continue
+        error = abs(mclk * step / 1024 / (pdiv + 1) / 16 - baud)
+        if (best is None or error < best[0]):
+            best = (error, step, pdiv)
+    if (best is None or best[0] > baud * 0.02):
+        print("ERROR: Baud rate", baud, "not reachable with MCLK", mclk)
+        exit(1)
+    return best[1], best[2]
+
+
+def lz_compress(data):
+    # format inflated by Stage1/stage1.c
+    out = bytearray()
+    literals = bytearray()
+    table = {}
+    i = 0
+
+    def flush():
+        while (literals):
+            chunk = literals[:128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+            del literals[:128]
+
+    while (i < len(data)):
+        key = bytes(data[i:i + 3])
+        match = table.get(key)
+        table[key] = i
+        if (match is not None and len(key) == 3 and i - match < 0x10000):
+            length = 3
+            while (i + length < len(data) and length < 130 and data[match + length] == data[i + length]):
+                length += 1
+            flush()
+            out.append(0x80 + length - 3)
+            out.extend((i - match).to_bytes(2, 'little'))
+            for j in range(i + 1, i + length):
+                table[bytes(data[j:j + 3])] = j
+            i += length
+        else:
+            literals.append(data[i])
+            i += 1
+    flush()
+    return out
+
+
+if (args.stage1):
+    step, pdiv = usic_divider(args.mclk, args.baud)
+    ser.write(step.to_bytes(2, 'little') + pdiv.to_bytes(2, 'little'))
+    expect("stage 1 start", BSL_SUCCESS)
+    ser.baudrate = args.baud
+
+    try:
+        with open(args.bin, "rb") as f:
+            loader = bytearray(f.read())
+    except Exception:
+        print("ERROR: Could not open", args.bin)
+        exit(1)
+
+    packed = lz_compress(loader)
+    if (len(packed) >= len(loader)):
+        packed = bytearray()
+    print("Sending", args.bin, "at", args.baud, "baud:", len(loader), "bytes,", len(packed), "compressed")
+    ser.write(len(packed).to_bytes(4, 'little') + len(loader).to_bytes(4, 'little') +
+              (sum(loader) & 0xFFFFFFFF).to_bytes(4, 'little'))
+    ser.write(packed if packed else loader)
+    expect("stage 2 upload", BSL_SUCCESS)
+
+if (args.program is None and args.bmi is None and not args.stats and not args.info and not args.swd):
+    exit(0)
+
+# SRAM loader announces itself once after start
+expect("loader start", BSL_SUCCESS)
+
+
+def read_reply(mode, what):
+    reply = ser.read(16)
+    if (len(reply) != 16 or reply[0] != 0x01 or reply[1] != mode or xor(reply[:15]) != reply[15]):
+        print("ERROR: Bad reply to", what)
+        exit(1)
+    return reply[2:15]
+
+
+def get_stats(page, index=0):
+    send_header(BSL_GET_STATS, bytearray([page, index]))
+    return read_reply(BSL_GET_STATS, "stats")
+
+
+def get_info():
+    send_header(BSL_GET_INFO, bytearray([BSL_INFO_LOADER]))
+    reply = ser.read(16)
+    if (len(reply) != 16 or reply[0] != 0x01 or reply[1] != BSL_GET_INFO or xor(reply[:15]) != reply[15]):
+        # loader without BSL_GET_INFO (one byte BSL_MODE_ERROR): stop-and-wait, no window
+        ser.reset_input_buffer()
+        return {"version": 0, "commands": 0x7B, "options": 0x0F, "window": 1, "page": PAGE_SIZE,
+                "sector": SECTOR_SIZE, "flash": None}
+    data = reply[2:15]
+    info = {"version": data[0], "commands": int.from_bytes(data[1:3], 'big'), "options": data[3],
+            "buffers": int.from_bytes(data[4:6], 'big'), "buffer size": int.from_bytes(data[6:8], 'big'),
+            "window": data[8], "mclk": int.from_bytes(data[9:13], 'big')}
+    send_header(BSL_GET_INFO, bytearray([BSL_INFO_CHIP]))
+    data = read_reply(BSL_GET_INFO, "info")
+    info.update({"page": int.from_bytes(data[0:2], 'big'), "sector": int.from_bytes(data[2:4], 'big'),
+                 "flash": int.from_bytes(data[4:8], 'big'), "chip": int.from_bytes(data[8:12], 'big')})
+    return info
+
+
+def get_stage_size():
+    send_header(BSL_GET_INFO, bytearray([BSL_INFO_STAGE]))
+    data = read_reply(BSL_GET_INFO, "stage info")
+    return int.from_bytes(data[0:3], 'big'), int.from_bytes(data[3:7], 'big')
+
+
+def swd_connect(delay):
+    send_header(BSL_SWD, bytearray([BSL_SWD_CONNECT, delay]))
+    data = read_reply(BSL_SWD, "SWD connect")
+    return data[0], int.from_bytes(data[1:5], 'big')
+
+
+def swd_transfer(requests):
+    # (request, data) pairs, data is ignored by reads; returns the data read.
+    # The loader runs up to SWD_BATCH_MAX requests per round trip.
+    reads = []
+    for offset in range(0, len(requests), SWD_BATCH_MAX):
+        batch = requests[offset:offset + SWD_BATCH_MAX]
+        records = bytearray()
+        for request, value in batch:
+            records += bytearray([request]) + value.to_bytes(4, 'big')
+        send_header(BSL_SWD, bytearray([BSL_SWD_TRANSFER, len(batch)]))
+        ser.write(records + bytearray([xor(records)]))
+        head, data = swd_reply("SWD transfer", lambda done: sum(1 for r, v in batch[:done] if r & SWD_REQ_RnW))
+        reads += [int.from_bytes(data[i:i + 4], 'big') for i in range(0, len(data), 4)]
+        if (head[0] != BSL_SUCCESS):
+            print("ERROR: SWD request", offset + head[1], "failed, ACK", hex(head[2]))
+            exit(1)
+    return reads
+
+
+def swd_reply(what, words):
+    # code, count, ACK, words(count) data words and the XOR checksum of it all
+    head = ser.read(3)
+    if (len(head) != 3):
+        print("ERROR: No valid reply to", what)
+        exit(1)
+    data = ser.read(4 * words(head[1]))
+    chksum = ser.read(1)
+    if (len(data) != 4 * words(head[1]) or len(chksum) != 1 or xor(head + data) != chksum[0]):
+        print("ERROR: Bad reply to", what)
+        exit(1)
+    return head, data
+
+
+def swd_memory(address, image=None, size=0):
+    # writes image or reads size bytes at address through the AHB-AP of the
+    # target, SWD_BLOCK_MAX words per round trip; the loader rewrites TAR at
+    # 1 KB boundaries. CSW of AP 0 must be set to SWD_CSW_WORD_INC.
+    data = bytearray()
+    length = len(image) if image is not None else size
+    for offset in range(0, length, 4 * SWD_BLOCK_MAX):
+        count = min(SWD_BLOCK_MAX, (length - offset + 3) // 4)
+        header = bytearray([BSL_SWD_WRITE_BLOCK if image is not None else BSL_SWD_READ_BLOCK])
+        send_header(BSL_SWD, header + (address + offset).to_bytes(4, 'big') + bytearray([count]))
+        if (image is not None):
+            block = image[offset:offset + 4 * count]
+            block += bytearray(4 * count - len(block))
+            ser.write(block + bytearray([xor(block)]))
+        head, words = swd_reply("SWD block access", lambda count: count)
+        if (head[0] != BSL_SUCCESS):
+            print("ERROR: SWD block access at", hex(address + offset), "failed, ACK", hex(head[2]))
+            exit(1)
+        data += words
+    return data[:length]
+
+
+# pick the fastest mode the running loader supports
+info = get_info()
+if (args.info):
+    if (info["version"] == 0):
+        print("Loader does not report its features (protocol 0)")
+    else:
+        print("Protocol:", info["version"], " commands:", hex(info["commands"]), " program options:", hex(info["options"]))
+        print("Page buffers:", info["buffers"], "x", info["buffer size"], "bytes, window", info["window"])
+        print("Flash:", info["flash"], "bytes,", info["sector"], "byte sectors,", info["page"], "byte pages")
+        print("Chip ID:", hex(info["chip"]), " MCLK:", info["mclk"], "Hz")
+        if (info["options"] & BSL_PROG_STAGE):
+            jedec, size = get_stage_size()
+            print("SPI flash:", size, "bytes, JEDEC ID", hex(jedec))
+
+
+if (args.swd):
+    if (not (info["commands"] & (1 << BSL_SWD))):
+        print("ERROR: Loader has no SWD host (build it with SWD_HOST=1)")
+        exit(1)
+    ack, dpidr = swd_connect(args.swd_delay)
+    if (ack != SWD_ACK_OK):
+        print("ERROR: No SWD target, ACK", hex(ack))
+        exit(1)
+    # clear sticky errors, power up the debug domain and read the IDR of AP 0
+    # (bank 0xF, register 0xC); AP reads are posted, RDBUFF returns the IDR
+    status, _, idr = swd_transfer([(SWD_DP_ABORT, 0x1E), (SWD_DP_CTRL_STAT, 0x50000000),
+                                   (SWD_DP_CTRL_STAT | SWD_REQ_RnW, 0), (SWD_DP_SELECT, 0xF0),
+                                   (0x0C | SWD_REQ_APnDP | SWD_REQ_RnW, 0), (SWD_DP_RDBUFF | SWD_REQ_RnW, 0)])
+    print("SWD target: DPIDR", hex(dpidr), " AP 0 IDR", hex(idr), " CTRL/STAT", hex(status))
+
+    if (args.swd_write is not None):
+        try:
+            with open(args.swd_write, "rb") as f:
+                image = bytearray(f.read())
+        except Exception:
+            print("ERROR: Could not open", args.swd_write)
+            exit(1)
+        if (args.swd_address % 4):
+            print("ERROR: SWD address must be word aligned")
+            exit(1)
+        swd_transfer([(SWD_DP_SELECT, 0), (SWD_AP_CSW | SWD_REQ_APnDP, SWD_CSW_WORD_INC)])
+        print("Writing", len(image), "bytes at", hex(args.swd_address), "over SWD")
+        swd_memory(args.swd_address, image)
+        if (swd_memory(args.swd_address, size=len(image)) != image):
+            print("ERROR: SWD read back differs from", args.swd_write)
+            exit(1)
+
+
+if (args.program is not None):
+    try:
+        with open(args.program, "rb") as f:
+            image = bytearray(f.read())
+    except Exception:
+        print("ERROR: Could not open", args.program)
+        exit(1)
+
+    image += bytearray([0xFF]) * (-len(image) % PAGE_SIZE)
+    if (info["flash"] is not None and args.address + len(image) > FLASH_BASE + info["flash"]):
+        print("ERROR: Image does not fit into", info["flash"], "bytes of flash")
+        exit(1)
+
+    pages = [image[offset:offset + PAGE_SIZE] for offset in range(0, len(image), PAGE_SIZE)]
+    target = args.address
+    extra = bytearray()
+    if (args.stage):
+        if (not (info["options"] & BSL_PROG_STAGE)):
+            print("ERROR: Loader has no SPI flash staging (build it with SPI_FLASH=1)")
+            exit(1)
+        jedec, size = get_stage_size()
+        if (args.stage_address % PAGE_SIZE or args.stage_address + len(image) > size):
+            print("ERROR: Image does not fit into", size, "bytes of SPI flash (ID", hex(jedec) + ")")
+            exit(1)
+        # the loader erases the staging area before it replies to the header
+        options = BSL_PROG_STAGE
+        target = args.stage_address
+        extra = len(pages).to_bytes(2, 'big')
+    elif (args.lazy_erase):
+        options = BSL_PROG_LAZY_ERASE | BSL_PROG_VERIFY
+    else:
+        size = info["sector"]
+        first = args.address & ~(size - 1)
+        for sector in range(first, args.address + len(image), size):
+            print("Erasing sector", hex(sector))
+            send_header(BSL_ERASE_FLASH, sector.to_bytes(4, 'big') + size.to_bytes(4, 'big'))
+            expect("erase", BSL_ERASE_SUCCESS)
+        # sectors were erased above, so the loader can skip the per page erase
+        options = BSL_PROG_ERASED | BSL_PROG_VERIFY
+    options |= BSL_PROG_WINDOW if (info["options"] & BSL_PROG_WINDOW) else BSL_PROG_SEQUENCE
+
+    print("Staging" if args.stage else "Programming", len(image), "bytes at", hex(target))
+    send_header(BSL_PROGRAM_FLASH, target.to_bytes(4, 'big') + bytearray([options]) + extra)
+    ser.timeout = STAGE_ERASE_TIMEOUT / 1000.0 * (len(image) // 0x10000 + 1) if args.stage else TIMEOUT / 1000.0
+    expect("program header", BSL_SUCCESS)
+    ser.timeout = TIMEOUT / 1000.0
+    window = 1
+    if (options & BSL_PROG_WINDOW):
+        window = ser.read(1)
+        if (len(window) != 1 or window[0] == 0):
+            print("ERROR: No window size in the program header reply")
+            exit(1)
+        window = window[0]
+    base = 0
+    sent = 0
+    retries = 0
+    # up to window blocks in flight, replies are (code, sequence number):
+    # an ACK covers all blocks up to its number, a NAK names the block to go back to.
+    # The EOT block is number len(pages) and needs no buffer on the loader.
+    while (base <= len(pages)):
+        while (sent < len(pages) and sent < base + window):
+            ser.write(data_block(sent, pages[sent]))
+            sent += 1
+        if (sent == len(pages)):
+            ser.write(eot_block(sent))
+            sent += 1
+        what = "page " + hex(target + base * PAGE_SIZE) if base < len(pages) else "end of program"
+        reply = ser.read(2)
+        if (len(reply) == 2):
+            delta = (reply[1] - base) & 0xFF
+            if (delta >= 0x80):
+                delta -= 0x100
+            if (reply[0] == BSL_SUCCESS):
+                if (delta >= 0):
+                    base += delta + 1
+                    retries = 0
+                continue
+            if (reply[0] not in BLOCK_NAKS):
+                print("ERROR:", what, "failed, received:", hex(reply[0]))
+                exit(1)
+        retries += 1
+        if (retries > BLOCK_RETRIES):
+            print("ERROR: No valid response to", what)
+            exit(1)
+        if (len(reply) == 2):
+            # go back to the block the loader expects
+            sent = base + max(delta, 0)
+        else:
+            # lost reply or lost bytes: repeat all unacknowledged blocks
+            ser.reset_input_buffer()
+            sent = base
+
+    if (args.stage):
+        # the loader programs the flash from the SPI flash, the UART idles meanwhile
+        print("Programming", len(pages), "pages at", hex(args.address), "from the SPI flash")
+        # the loader checks the staged pages against the low 24 bits of their CRC-32 before it programs
+        send_header(BSL_STAGE_COMMIT, args.stage_address.to_bytes(4, 'big') + args.address.to_bytes(4, 'big') +
+                    len(pages).to_bytes(2, 'big') + (zlib.crc32(image) & 0xFFFFFF).to_bytes(3, 'big'))
+        ser.timeout = COMMIT_PAGE_TIMEOUT / 1000.0 * len(pages) + TIMEOUT / 1000.0
+        data = read_reply(BSL_STAGE_COMMIT, "stage commit")
+        ser.timeout = TIMEOUT / 1000.0
+        if (data[0] == BSL_VERIFY_ERROR):
+            print("ERROR: Staged image does not match its CRC, programmed pages:", int.from_bytes(data[1:3], 'big'))
+            exit(1)
+        if (data[0] != BSL_SUCCESS):
+            print("ERROR: Programming from the SPI flash failed at page", int.from_bytes(data[1:3], 'big'),
+                  "received:", hex(data[0]))
+            exit(1)
+
+    if (args.verify):
+        print("Verifying...")
+        for offset in range(0, len(image), 4):
+            send_header(BSL_READ_FLASH, (args.address + offset).to_bytes(4, 'big'))
+            reply = ser.read(16)
+            if (len(reply) != 16 or xor(reply[:15]) != reply[15]):
+                print("ERROR: Bad read reply at", hex(args.address + offset))
+                exit(1)
+            if (reply[6:10] != image[offset:offset + 4]):
+                print("ERROR: Verify failed at", hex(args.address + offset))
+                exit(1)
+
+if (args.stats):
+    data = get_stats(BSL_STATS_SRAM)
+    print("Stack:", int.from_bytes(data[2:4], 'big'), "of", int.from_bytes(data[0:2], 'big'), "bytes used")
+    print("Page buffers:", int.from_bytes(data[4:6], 'big'), "x", int.from_bytes(data[6:8], 'big'), "bytes")
+    for pool, name in enumerate(POOL_NAMES):
+        data = get_stats(BSL_STATS_POOL, pool)
+        size, count, used, peak, failed = [int.from_bytes(data[i:i + 2], 'big') for i in range(0, 10, 2)]
+        print(name, "pool:", count, "x", size, "bytes,", used, "used,", peak, "peak,", failed, "failed")
+
+if (args.bmi is not None and args.program is not None and info["commands"] & (1 << BSL_FINALIZE)):
+    # CRC check and BMI change in one command, the loader replies before it resets
+    crc = zlib.crc32(image) & 0xFFFFFFFF
+    print("Checking CRC", hex(crc), "and installing BMI", hex(args.bmi))
+    send_header(BSL_FINALIZE, args.address.to_bytes(4, 'big') + (len(image) // PAGE_SIZE).to_bytes(2, 'big') +
+                crc.to_bytes(4, 'big') + args.bmi.to_bytes(2, 'big'))
+    # the loader computes the CRC over the whole image before it replies
+    ser.timeout = CRC_PAGE_TIMEOUT / 1000.0 * (len(image) // PAGE_SIZE) + TIMEOUT / 1000.0
+    data = read_reply(BSL_FINALIZE, "finalize")
+    ser.timeout = TIMEOUT / 1000.0
+    if (data[0] != BSL_SUCCESS):
+        print("ERROR: CRC mismatch, flash has", hex(int.from_bytes(data[1:5], 'big')) + ", BMI not changed")
+        exit(1)
+    byte = ser.read()
+    if (byte):
+        print("ERROR: BMI value rejected, received:", hex(byte[0]))
+        exit(1)
+elif (args.bmi is not None):
+    print("Installing BMI", hex(args.bmi))
+    send_header(BSL_CHANGE_BMI, args.bmi.to_bytes(2, 'big'))
+    byte = ser.read()
+    if (byte):
+        print("ERROR: BMI value rejected, received:", hex(byte[0]))
+        exit(1)
+
+print("Done!")